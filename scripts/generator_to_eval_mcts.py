@@ -22,6 +22,8 @@ Parameters :
     s,simulation
     O,O_time
     P,P_time
+    threads
+    parallel
     o,output_file
 
 """
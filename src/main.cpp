@@ -12,6 +12,7 @@
 
 #include "methods/LocalSearch.h"
 #include "methods/MCTS.h"
+#include "methods/Portfolio.h"
 #include "representation/Graph.h"
 #include "representation/Method.h"
 #include "representation/Parameters.h"
@@ -49,7 +50,7 @@ int main(int argc, const char *argv[]) {
 
 void signal_handler(int signum) {
     fmt::print(stderr, "\nInterrupt signal ({}) received.\n", signum);
-    Parameters::p->time_stop = std::chrono::high_resolution_clock::now();
+    Parameters::p->stop_search();
 }
 
 std::unique_ptr<Method> parse(int argc, const char **argv) {
@@ -101,9 +102,15 @@ std::unique_ptr<Method> parse(int argc, const char **argv) {
                 //
                 ));
 
+        options.allow_unrecognised_options().add_options()(
+            "g,graph_cache",
+            "directory of the binary cache of the instances (created on the first run "
+            "and reloaded on the next runs), let empty to parse the instance files",
+            cxxopts::value<std::string>()->default_value(""));
+
         options.allow_unrecognised_options().add_options()(
             "m,method",
-            "method (mcts, local_search)",
+            "method (mcts, local_search, portfolio)",
             cxxopts::value<std::string>()->default_value(
                 //
                 "mcts"
@@ -186,9 +193,10 @@ std::unique_ptr<Method> parse(int argc, const char **argv) {
 
         options.allow_unrecognised_options().add_options()(
             "M,max_time_local_search",
-            "Time limit in seconds for local search when call from another method or not "
-            "can by override by nb_iter_local_search or o and t time",
-            cxxopts::value<int>()->default_value(
+            "Time limit in seconds (can be fractional, ex : 0.05) for local search when "
+            "call from another method or not can by override by nb_iter_local_search or "
+            "o and t time",
+            cxxopts::value<double>()->default_value(
                 //
                 // time_limit
                 "-1"
@@ -240,6 +248,85 @@ std::unique_ptr<Method> parse(int argc, const char **argv) {
             "P to calculate the time of RL : O+P*nb_vertices seconds",
             cxxopts::value<double>()->default_value("0.2"));
 
+        options.allow_unrecognised_options().add_options()(
+            "threads",
+            "number of threads, for the mcts each thread builds its own tree and they "
+            "share the best found solution (root parallelization)",
+            cxxopts::value<int>()->default_value("1"));
+
+        options.allow_unrecognised_options().add_options()(
+            "parallel",
+            "parallelization of the mcts with several threads (root : one tree per "
+            "thread, tree : the threads share the same tree)",
+            cxxopts::value<std::string>()->default_value(
+                //
+                "root"
+                // "tree"
+                //
+                ));
+
+        options.allow_unrecognised_options().add_options()(
+            "max_tree_nodes",
+            "maximal number of nodes of the mcts trees (0 for no limit), the least "
+            "visited branches are collapsed back into the possible moves of their parent "
+            "when the limit is reached",
+            cxxopts::value<long>()->default_value("0"));
+
+        options.allow_unrecognised_options().add_options()(
+            "max_tree_memory",
+            "maximal memory of the mcts trees in MB (0 for no limit), same as "
+            "max_tree_nodes with the memory used by the nodes",
+            cxxopts::value<long>()->default_value("0"));
+
+        options.allow_unrecognised_options().add_options()(
+            "local_search_selection",
+            "for the mcts, choose the local search of each simulation among the local "
+            "searches given with --local_search separated by ':' (ex : "
+            "tabu_weight:redls:ilsts:afisa) with a bandit rewarding the improvement of "
+            "the score per second (none, ucb1, exp3)",
+            cxxopts::value<std::string>()->default_value(
+                //
+                "none"
+                // "ucb1"
+                // "exp3"
+                //
+                ));
+
+        options.allow_unrecognised_options().add_options()(
+            "transposition_table_size",
+            "for the mcts, number of entries of the table keeping the scores of the "
+            "simulations of the partial colorations, shared by the threads and reused "
+            "when a partial coloration is expanded again (16 bytes per entry, 0 for no "
+            "table)",
+            cxxopts::value<long>()->default_value("0"));
+
+        options.allow_unrecognised_options().add_options()(
+            "local_search_pool",
+            "for the mcts with the local_search simulation, number of local searches of "
+            "each thread suspended between their steps and resumed in turn, the worst "
+            "ones are stopped early when their step didn't improve them (0 to run each "
+            "local search until its end)",
+            cxxopts::value<int>()->default_value("0"));
+
+        options.allow_unrecognised_options().add_options()(
+            "local_search_slice",
+            "number of turns of a suspended local search before resuming the next one "
+            "(see local_search_pool)",
+            cxxopts::value<long>()->default_value("1000"));
+
+        options.allow_unrecognised_options().add_options()(
+            "portfolio",
+            "for the portfolio method, searches of the workers separated by ':' (mcts or "
+            "a local search, ex : mcts:redls:ilsts), given in turn to the --threads "
+            "workers (the local searches restart from a new initial solution until the "
+            "time limit)",
+            cxxopts::value<std::string>()->default_value(
+                //
+                "mcts"
+                // "mcts:tabu_weight:redls:ilsts"
+                //
+                ));
+
         options.allow_unrecognised_options().add_options()(
             "o,output_file",
             "output file, let empty if output to stdout",
@@ -293,12 +380,13 @@ std::unique_ptr<Method> parse(int argc, const char **argv) {
         }
 
         const std::string instance = result["instance"].as<std::string>();
-        Graph::init_graph(instance, problem);
+        const std::string graph_cache = result["graph_cache"].as<std::string>();
+        Graph::init_graph(instance, problem, graph_cache);
 
         const std::string method = result["method"].as<std::string>();
 
         const int rand_seed = result["rand_seed"].as<int>();
-        rd::generator.seed(rand_seed);
+        rd::seed(rand_seed, 0);
 
         const int target = result["target"].as<int>();
         const bool use_target = result["use_target"].as<bool>();
@@ -318,7 +406,7 @@ std::unique_ptr<Method> parse(int argc, const char **argv) {
         const std::string initialization = result["initialization"].as<std::string>();
         const long nb_iter_local_search = result["nb_iter_local_search"].as<long>();
 
-        int max_time_local_search = result["max_time_local_search"].as<int>();
+        double max_time_local_search = result["max_time_local_search"].as<double>();
 
         const double coeff_exploi_explo = result["coeff_exploi_explo"].as<double>();
         const std::string local_search = result["local_search"].as<std::string>();
@@ -326,13 +414,73 @@ std::unique_ptr<Method> parse(int argc, const char **argv) {
 
         const int O_time = result["O_time"].as<int>();
         const double P_time = result["P_time"].as<double>();
-        if (max_time_local_search == -1) {
+        if (max_time_local_search < 0) {
             max_time_local_search = std::max(
                 1,
                 static_cast<int>(static_cast<double>(Graph::g->nb_vertices) * P_time) +
                     O_time);
         }
 
+        const int nb_threads = result["threads"].as<int>();
+        if (nb_threads < 1) {
+            fmt::print(stderr, "the number of threads must be at least 1\n");
+            exit(1);
+        }
+        const std::string parallel = result["parallel"].as<std::string>();
+        if (parallel != "root" and parallel != "tree") {
+            fmt::print(stderr,
+                       "unknown parallelization {}\n"
+                       "select :\n"
+                       "\troot (one tree per thread)\n"
+                       "\ttree (one tree shared by the threads)",
+                       parallel);
+            exit(1);
+        }
+
+        const long max_tree_nodes = result["max_tree_nodes"].as<long>();
+        const long max_tree_memory = result["max_tree_memory"].as<long>();
+        if (max_tree_nodes < 0 or max_tree_memory < 0) {
+            fmt::print(stderr, "the limits of the tree must be positive (or 0)\n");
+            exit(1);
+        }
+
+        const std::string local_search_selection =
+            result["local_search_selection"].as<std::string>();
+        if (local_search_selection != "none" and
+            (method != "mcts" or simulation == "greedy")) {
+            fmt::print(stderr,
+                       "the selection of the local search needs the mcts with a "
+                       "simulation using a local search\n");
+            exit(1);
+        }
+
+        const long transposition_table_size =
+            result["transposition_table_size"].as<long>();
+        if (transposition_table_size < 0) {
+            fmt::print(stderr,
+                       "the size of the transposition table must be positive (or 0)\n");
+            exit(1);
+        }
+
+        const int local_search_pool = result["local_search_pool"].as<int>();
+        const long local_search_slice = result["local_search_slice"].as<long>();
+        if (local_search_pool < 0 or local_search_slice < 1) {
+            fmt::print(stderr,
+                       "the pool of local searches must be positive (or 0) and the "
+                       "slice at least 1\n");
+            exit(1);
+        }
+        if (local_search_pool > 0 and
+            (method == "local_search" or simulation != "local_search" or
+             local_search == "none" or local_search_selection != "none")) {
+            fmt::print(stderr,
+                       "the pool of local searches needs the mcts with the local_search "
+                       "simulation and one local search\n");
+            exit(1);
+        }
+
+        const std::string portfolio = result["portfolio"].as<std::string>();
+
         const std::string output_file = result["output_file"].as<std::string>();
 
         // init parameters
@@ -353,6 +501,15 @@ std::unique_ptr<Method> parse(int argc, const char **argv) {
                                                      simulation,
                                                      O_time,
                                                      P_time,
+                                                     nb_threads,
+                                                     parallel,
+                                                     max_tree_nodes,
+                                                     max_tree_memory,
+                                                     local_search_selection,
+                                                     transposition_table_size,
+                                                     local_search_pool,
+                                                     local_search_slice,
+                                                     portfolio,
                                                      output_file);
 
         // the method can't be created before the parameters
@@ -362,10 +519,13 @@ std::unique_ptr<Method> parse(int argc, const char **argv) {
         if (method == "mcts") {
             return std::make_unique<MCTS>();
         }
+        if (method == "portfolio") {
+            return std::make_unique<Portfolio>();
+        }
 
         fmt::print(stderr,
                    "error unknown method : {}\n"
-                   "Possible method : mcts, local_search",
+                   "Possible method : mcts, local_search, portfolio",
                    method);
         exit(1);
 
@@ -13,7 +13,8 @@
 LocalSearch::LocalSearch()
     : _best_solution(),
       _init_function(get_initialization_fct(Parameters::p->initialization)),
-      _local_search_function(get_local_search_fct(Parameters::p->local_search)) {
+      _local_search_function(get_local_search_fct(Parameters::p->local_search)),
+      _workspace() {
     _init_function(_best_solution);
 }
 
@@ -21,7 +22,7 @@ void LocalSearch::run() {
     fmt::print(Parameters::p->output, "{}", header_csv());
     fmt::print(Parameters::p->output, "{}", line_csv());
     if (_local_search_function) {
-        _local_search_function(_best_solution, true);
+        _local_search_function(_best_solution, _workspace, true);
     }
 }
 
@@ -66,3 +67,31 @@ local_search_ptr get_local_search_fct(const std::string &local_search) {
                "afisa, afisa_original, redls, redls_freeze, ilsts\n");
     exit(1);
 }
+
+std::unique_ptr<ResumableLocalSearch> make_local_search(const std::string &local_search,
+                                                        Solution &solution,
+                                                        LocalSearchWorkspace &workspace,
+                                                        const bool verbose) {
+    if (local_search == "hill_climbing")
+        return std::make_unique<HillClimbing>(solution, workspace, verbose);
+    if (local_search == "tabu_col")
+        return std::make_unique<TabuCol>(solution, workspace, verbose);
+    if (local_search == "tabu_weight")
+        return std::make_unique<TabuWeight>(solution, workspace, verbose);
+    if (local_search == "afisa")
+        return std::make_unique<Afisa>(solution, workspace, verbose);
+    if (local_search == "afisa_original")
+        return std::make_unique<AfisaOriginal>(solution, workspace, verbose);
+    if (local_search == "redls")
+        return std::make_unique<RedLS>(solution, workspace, verbose);
+    if (local_search == "redls_freeze")
+        return std::make_unique<RedLSFreeze>(solution, workspace, verbose);
+    if (local_search == "ilsts")
+        return std::make_unique<ILSTS>(solution, workspace, verbose);
+
+    fmt::print(stderr,
+               "Unknown resumable local_search, please select : "
+               "hill_climbing, tabu_col, tabu_weight, "
+               "afisa, afisa_original, redls, redls_freeze, ilsts\n");
+    exit(1);
+}
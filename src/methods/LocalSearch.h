@@ -1,12 +1,16 @@
 #pragma once
 
+#include <memory>
+
 #include "../representation/Method.h"
 #include "../representation/Solution.h"
 #include "../representation/enum_types.h"
+#include "LocalSearchWorkspace.h"
+#include "ResumableLocalSearch.h"
 #include "greedy.h"
 
 /** @brief Pointer to local search function*/
-typedef void (*local_search_ptr)(Solution &, const bool);
+typedef void (*local_search_ptr)(Solution &, LocalSearchWorkspace &, const bool);
 
 /**
  * @brief Method for local search
@@ -21,6 +25,8 @@ class LocalSearch : public Method {
     init_ptr _init_function;
     /** @brief Local search function*/
     local_search_ptr _local_search_function;
+    /** @brief Buffers of the local search*/
+    LocalSearchWorkspace _workspace;
 
   public:
     explicit LocalSearch();
@@ -54,3 +60,17 @@ class LocalSearch : public Method {
  * @return local_search_ptr function local search
  */
 local_search_ptr get_local_search_fct(const std::string &local_search);
+
+/**
+ * @brief Create the resumable version of the local search
+ *
+ * @param local_search name of the local search (not none)
+ * @param solution solution to use, the solution will be modified
+ * @param workspace buffers of the local search (one per search kept alive)
+ * @param verbose True if print csv line each time new best scores is found
+ * @return std::unique_ptr<ResumableLocalSearch> the local search
+ */
+std::unique_ptr<ResumableLocalSearch> make_local_search(const std::string &local_search,
+                                                        Solution &solution,
+                                                        LocalSearchWorkspace &workspace,
+                                                        const bool verbose);
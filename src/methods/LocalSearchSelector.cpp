@@ -0,0 +1,118 @@
+#include "LocalSearchSelector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "../utils/random_generator.h"
+#include "../utils/utils.h"
+
+LocalSearchSelector::LocalSearchSelector(const std::string &selection,
+                                         const std::string &local_searches)
+    : _selection(selection) {
+    if (_selection == "none") {
+        return;
+    }
+    if (_selection != "ucb1" and _selection != "exp3") {
+        fmt::print(stderr,
+                   "Unknown local_search_selection, please select : none, ucb1, exp3\n");
+        exit(1);
+    }
+    _names = split_string(local_searches, ":");
+    for (const auto &name : _names) {
+        const local_search_ptr local_search{get_local_search_fct(name)};
+        if (not local_search) {
+            fmt::print(stderr,
+                       "The local searches of local_search_selection must be separated "
+                       "by ':' and can't be none\n");
+            exit(1);
+        }
+        _local_searches.push_back(local_search);
+    }
+    _nb_rewards.resize(_names.size(), 0);
+    _sum_rewards.resize(_names.size(), 0);
+    _log_weights.resize(_names.size(), 0);
+}
+
+[[nodiscard]] bool LocalSearchSelector::active() const {
+    return not _local_searches.empty();
+}
+
+[[nodiscard]] std::vector<double> LocalSearchSelector::exp3_probabilities() const {
+    const double max_log_weight{
+        *std::max_element(_log_weights.begin(), _log_weights.end())};
+    std::vector<double> probabilities(_log_weights.size());
+    double sum_weights{0};
+    for (size_t i{0}; i < _log_weights.size(); ++i) {
+        // shifted by the max weight to avoid overflows
+        probabilities[i] = std::exp(_log_weights[i] - max_log_weight);
+        sum_weights += probabilities[i];
+    }
+    const auto nb_arms{static_cast<double>(_log_weights.size())};
+    for (auto &probability : probabilities) {
+        probability =
+            (1 - exp3_gamma) * probability / sum_weights + exp3_gamma / nb_arms;
+    }
+    return probabilities;
+}
+
+[[nodiscard]] int LocalSearchSelector::select() {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    if (_selection == "exp3") {
+        const auto probabilities{exp3_probabilities()};
+        std::discrete_distribution<int> distribution(probabilities.begin(),
+                                                     probabilities.end());
+        return distribution(rd::generator);
+    }
+    // UCB1, each local search is tried once first
+    int best_local_search{0};
+    double best_value{-1};
+    for (size_t i{0}; i < _nb_rewards.size(); ++i) {
+        if (_nb_rewards[i] == 0) {
+            return static_cast<int>(i);
+        }
+        const auto nb_rewards{static_cast<double>(_nb_rewards[i])};
+        const double value{
+            _sum_rewards[i] / nb_rewards +
+            std::sqrt(2 * std::log(static_cast<double>(_nb_total_rewards)) / nb_rewards)};
+        if (value > best_value) {
+            best_value = value;
+            best_local_search = static_cast<int>(i);
+        }
+    }
+    return best_local_search;
+}
+
+void LocalSearchSelector::reward(const int local_search, const double gain_rate) {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    _window_max_gain_rate = std::max(_window_max_gain_rate, gain_rate);
+    // the bandits expect rewards between 0 and 1, a local search worsening the score
+    // gets 0 and the best improvements of the window may exceed the scale
+    const double scale{_scale_gain_rate > 0 ? _scale_gain_rate : _window_max_gain_rate};
+    const double reward{scale > 0 ? std::clamp(gain_rate / scale, 0.0, 1.0) : 0};
+    if (_selection == "exp3") {
+        // importance weighted reward of the selected local search
+        const double probability{exp3_probabilities()[local_search]};
+        _log_weights[local_search] += exp3_gamma * reward / probability /
+                                      static_cast<double>(_log_weights.size());
+    }
+    ++_nb_rewards[local_search];
+    _sum_rewards[local_search] += reward;
+    ++_nb_total_rewards;
+    if (_nb_total_rewards % reward_window == 0) {
+        // the next window is normalised with the best improvement of this one
+        if (_window_max_gain_rate > 0) {
+            _scale_gain_rate = _window_max_gain_rate;
+        }
+        _window_max_gain_rate = 0;
+    }
+}
+
+[[nodiscard]] local_search_ptr
+LocalSearchSelector::local_search_fct(const int local_search) const {
+    return _local_searches[local_search];
+}
+
+[[nodiscard]] const std::string &LocalSearchSelector::name(const int local_search) const {
+    return _names[local_search];
+}
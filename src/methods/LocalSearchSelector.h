@@ -0,0 +1,105 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "LocalSearch.h"
+
+/**
+ * @brief Adaptive selection of the local search of the MCTS simulations
+ *
+ * The local searches are the arms of a multi-armed bandit (UCB1 or Exp3). The reward
+ * of a local search is its improvement of the score per second, divided by the best
+ * improvement per second of the previous window of rewards (so the rewards of a window
+ * share the same scale) and clamped between 0 and 1. The selector is shared by the
+ * threads of the MCTS.
+ *
+ */
+class LocalSearchSelector {
+
+    /** @brief Exploration rate of Exp3*/
+    static constexpr double exp3_gamma{0.1};
+    /** @brief Number of rewards normalised with the same best improvement per second*/
+    static constexpr long reward_window{100};
+
+    /** @brief Bandit policy (none, ucb1, exp3)*/
+    const std::string _selection;
+    /** @brief Names of the local searches*/
+    std::vector<std::string> _names{};
+    /** @brief Functions of the local searches*/
+    std::vector<local_search_ptr> _local_searches{};
+    /** @brief For each local search, number of rewards*/
+    std::vector<long> _nb_rewards{};
+    /** @brief For each local search, sum of the rewards (UCB1)*/
+    std::vector<double> _sum_rewards{};
+    /** @brief For each local search, logarithm of the weight (Exp3)*/
+    std::vector<double> _log_weights{};
+    /** @brief Total number of rewards*/
+    long _nb_total_rewards{0};
+    /** @brief Best improvement per second of the previous window of rewards, used to
+     * normalise the rewards of the current window (0 until a window improved the score)*/
+    double _scale_gain_rate{0};
+    /** @brief Best improvement per second of the current window of rewards*/
+    double _window_max_gain_rate{0};
+    /** @brief Protect the statistics (shared by the threads)*/
+    std::mutex _mutex;
+
+    /**
+     * @brief Return the probabilities of selection of the local searches (Exp3)
+     *
+     * @return std::vector<double> probabilities
+     */
+    [[nodiscard]] std::vector<double> exp3_probabilities() const;
+
+  public:
+    /**
+     * @brief Construct the selector
+     *
+     * @param selection bandit policy (none, ucb1, exp3), none for no selection
+     * @param local_searches names of the local searches separated by ':'
+     */
+    LocalSearchSelector(const std::string &selection, const std::string &local_searches);
+
+    LocalSearchSelector(const LocalSearchSelector &other) = delete;
+    LocalSearchSelector &operator=(const LocalSearchSelector &other) = delete;
+
+    /**
+     * @brief Return true if the selector chooses the local search of the simulations
+     *
+     * @return true the local search must be selected at each simulation
+     * @return false the local search is given by the parameters
+     */
+    [[nodiscard]] bool active() const;
+
+    /**
+     * @brief Choose a local search according to the policy
+     *
+     * @return int index of the local search
+     */
+    [[nodiscard]] int select();
+
+    /**
+     * @brief Give the reward of a run of the local search
+     *
+     * @param local_search index of the local search
+     * @param gain_rate improvement of the score per second of the run
+     */
+    void reward(const int local_search, const double gain_rate);
+
+    /**
+     * @brief Return the function of the local search
+     *
+     * @param local_search index of the local search
+     * @return local_search_ptr function of the local search
+     */
+    [[nodiscard]] local_search_ptr local_search_fct(const int local_search) const;
+
+    /**
+     * @brief Return the name of the local search
+     *
+     * @param local_search index of the local search
+     * @return const std::string& name of the local search
+     */
+    [[nodiscard]] const std::string &name(const int local_search) const;
+};
@@ -0,0 +1,79 @@
+#include "LocalSearchWorkspace.h"
+
+#include <algorithm>
+
+LocalSearchWorkspace::LocalSearchWorkspace()
+    : _moves_scan(0, 0, 0, 0),
+      _tabu_list(Graph::g->nb_vertices, false),
+      _tabu(Graph::g->nb_vertices, 0) {
+}
+
+[[nodiscard]] ProxiSolutionRedLS &
+LocalSearchWorkspace::redls_solution(const Solution &solution) {
+    if (_redls_solution) {
+        _redls_solution->reset(solution);
+    } else {
+        _redls_solution = std::make_unique<ProxiSolutionRedLS>(solution);
+    }
+    return *_redls_solution;
+}
+
+[[nodiscard]] ProxiSolutionILSTS &
+LocalSearchWorkspace::ilsts_solution(const Solution &solution) {
+    if (_ilsts_solution) {
+        _ilsts_solution->reset(solution);
+    } else {
+        _ilsts_solution = std::make_unique<ProxiSolutionILSTS>(solution);
+    }
+    return *_ilsts_solution;
+}
+
+[[nodiscard]] ProxiSolutionILSTS &
+LocalSearchWorkspace::ilsts_next_solution(const ProxiSolutionILSTS &solution) {
+    if (_ilsts_next_solution) {
+        *_ilsts_next_solution = solution;
+    } else {
+        _ilsts_next_solution = std::make_unique<ProxiSolutionILSTS>(solution);
+    }
+    return *_ilsts_next_solution;
+}
+
+[[nodiscard]] ProxiSolutionTabuWeight &LocalSearchWorkspace::tabu_weight_solution(
+    const Solution &solution, const int penalty_coeff, const bool legal_moves) {
+    if (_tabu_weight_solution) {
+        _tabu_weight_solution->reset(solution, penalty_coeff, legal_moves);
+    } else {
+        _tabu_weight_solution = std::make_unique<ProxiSolutionTabuWeight>(
+            solution, penalty_coeff, legal_moves);
+    }
+    return *_tabu_weight_solution;
+}
+
+[[nodiscard]] ProxiSolutionTabuCol &
+LocalSearchWorkspace::tabu_col_solution(const Solution &solution) {
+    if (_tabu_col_solution) {
+        _tabu_col_solution->reset(solution);
+    } else {
+        _tabu_col_solution = std::make_unique<ProxiSolutionTabuCol>(solution);
+    }
+    return *_tabu_col_solution;
+}
+
+[[nodiscard]] MovesScan &LocalSearchWorkspace::moves_scan(const int score_coeff,
+                                                          const int conflicts_coeff,
+                                                          const int max_delta_score,
+                                                          const int max_delta_conflicts) {
+    _moves_scan.set_coefficients(
+        score_coeff, conflicts_coeff, max_delta_score, max_delta_conflicts);
+    return _moves_scan;
+}
+
+[[nodiscard]] std::vector<bool> &LocalSearchWorkspace::tabu_list() {
+    std::fill(_tabu_list.begin(), _tabu_list.end(), false);
+    return _tabu_list;
+}
+
+[[nodiscard]] std::vector<long> &LocalSearchWorkspace::tabu() {
+    std::fill(_tabu.begin(), _tabu.end(), 0);
+    return _tabu;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "../representation/ProxiSolutionILSTS.h"
+#include "../representation/ProxiSolutionRedLS.h"
+#include "../representation/ProxiSolutionTabuCol.h"
+#include "../representation/ProxiSolutionTabuWeight.h"
+#include "../representation/Solution.h"
+#include "../utils/moves_scan.h"
+
+/**
+ * @brief Buffers of the local searches kept from one call to the next
+ *
+ * A workspace belongs to one thread (one per MCTS). The proxi solutions are created at
+ * their first use then reset from the new solution, so the short and frequent local
+ * searches of the simulations reuse their buffers instead of reallocating them.
+ *
+ */
+class LocalSearchWorkspace {
+
+    /** @brief Proxi solution of redls and redls_freeze*/
+    std::unique_ptr<ProxiSolutionRedLS> _redls_solution{};
+    /** @brief Current proxi solution of ilsts*/
+    std::unique_ptr<ProxiSolutionILSTS> _ilsts_solution{};
+    /** @brief Proxi solution of ilsts modified at each turn*/
+    std::unique_ptr<ProxiSolutionILSTS> _ilsts_next_solution{};
+    /** @brief Proxi solution of tabu_weight and afisa*/
+    std::unique_ptr<ProxiSolutionTabuWeight> _tabu_weight_solution{};
+    /** @brief Proxi solution of tabu_col*/
+    std::unique_ptr<ProxiSolutionTabuCol> _tabu_col_solution{};
+    /** @brief Scan of the moves of hill_climbing, redls and redls_freeze*/
+    MovesScan _moves_scan;
+    /** @brief Tabu list of redls and redls_freeze*/
+    std::vector<bool> _tabu_list{};
+    /** @brief Tabu list of ilsts*/
+    std::vector<long> _tabu{};
+
+  public:
+    /**
+     * @brief Construct an empty workspace (the graph must be loaded)
+     *
+     */
+    LocalSearchWorkspace();
+
+    LocalSearchWorkspace(const LocalSearchWorkspace &other) = delete;
+    LocalSearchWorkspace &operator=(const LocalSearchWorkspace &other) = delete;
+
+    /**
+     * @brief Return the proxi solution of redls reset from the solution
+     *
+     * @param solution the solution
+     * @return ProxiSolutionRedLS& the proxi solution
+     */
+    [[nodiscard]] ProxiSolutionRedLS &redls_solution(const Solution &solution);
+
+    /**
+     * @brief Return the current proxi solution of ilsts reset from the solution
+     *
+     * @param solution the solution
+     * @return ProxiSolutionILSTS& the proxi solution
+     */
+    [[nodiscard]] ProxiSolutionILSTS &ilsts_solution(const Solution &solution);
+
+    /**
+     * @brief Return the next proxi solution of ilsts as a copy of the proxi solution
+     *
+     * @param solution the proxi solution to copy
+     * @return ProxiSolutionILSTS& the copy
+     */
+    [[nodiscard]] ProxiSolutionILSTS &
+    ilsts_next_solution(const ProxiSolutionILSTS &solution);
+
+    /**
+     * @brief Return the proxi solution of tabu_weight reset from the solution
+     *
+     * @param solution the solution
+     * @param penalty_coeff coefficient of the penalty in the evaluation of the moves
+     * @param legal_moves true to forbid the moves to colors with conflicts
+     * @return ProxiSolutionTabuWeight& the proxi solution
+     */
+    [[nodiscard]] ProxiSolutionTabuWeight &tabu_weight_solution(
+        const Solution &solution, const int penalty_coeff, const bool legal_moves);
+
+    /**
+     * @brief Return the proxi solution of tabu_col reset from the solution
+     *
+     * @param solution the solution
+     * @return ProxiSolutionTabuCol& the proxi solution
+     */
+    [[nodiscard]] ProxiSolutionTabuCol &tabu_col_solution(const Solution &solution);
+
+    /**
+     * @brief Return the scan of the moves with the given coefficients and bounds (see
+     * MovesScan)
+     *
+     * @param score_coeff coefficient of the delta on the score in the key
+     * @param conflicts_coeff coefficient of the delta on the conflicts in the key
+     * @param max_delta_score the delta on the score of a possible move is lower
+     * @param max_delta_conflicts the delta on the conflicts of a possible move is lower
+     * or equal
+     * @return MovesScan& the scan
+     */
+    [[nodiscard]] MovesScan &moves_scan(const int score_coeff,
+                                        const int conflicts_coeff,
+                                        const int max_delta_score,
+                                        const int max_delta_conflicts);
+
+    /**
+     * @brief Return the tabu list of redls with no tabu vertex
+     *
+     * @return std::vector<bool>& for each vertex, true if the vertex is tabu
+     */
+    [[nodiscard]] std::vector<bool> &tabu_list();
+
+    /**
+     * @brief Return the tabu list of ilsts with no tabu vertex
+     *
+     * @return std::vector<long>& for each vertex, iteration until which it is tabu
+     */
+    [[nodiscard]] std::vector<long> &tabu();
+};
@@ -1,12 +1,17 @@
 #include "MCTS.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iomanip>
+#include <limits>
+#include <memory>
+#include <thread>
 #include <utility>
 
 #include "../utils/random_generator.h"
 #include "../utils/utils.h"
+#include "Portfolio.h"
 
 simulation_ptr get_simulation_fct(const std::string &simulation) {
     if (simulation == "fit") {
@@ -19,137 +24,393 @@ simulation_ptr get_simulation_fct(const std::string &simulation) {
     return nullptr;
 }
 
-MCTS::MCTS()
-    : _root_node(nullptr),
-      _current_node{_root_node},
+MCTS::MCTS(MCTS *main)
+    : _main(main ? main : this),
+      _tree(main and Parameters::p->parallel == "tree" ? main : this),
+      _root_node(),
+      _branch(),
       _base_solution(),
       _best_solution(),
       _current_solution(_base_solution),
       _turn{0},
       _initialization(get_initialization_fct(Parameters::p->initialization)),
-      _local_search(get_local_search_fct(Parameters::p->local_search)),
-      _simulation(get_simulation_fct(Parameters::p->simulation)) {
+      _local_search(Parameters::p->local_search_selection == "none"
+                        ? get_local_search_fct(Parameters::p->local_search)
+                        : nullptr),
+      _simulation(get_simulation_fct(Parameters::p->simulation)),
+      _workspace(),
+      _selector(main ? nullptr
+                     : std::make_unique<LocalSearchSelector>(
+                           Parameters::p->local_search_selection,
+                           Parameters::p->local_search)),
+      _transpositions(main ? 0 : Parameters::p->transposition_table_size) {
     if (Parameters::p->simulation == "greedy") {
         // security if the local search parameter wasn't set to "none"
         _local_search = nullptr;
     }
-    greedy_worst(_best_solution);
+    if (not main) {
+        greedy_worst(_best_solution);
+        _best_score = _best_solution.score_wvcp();
 
-    if (Parameters::p->use_target and Parameters::p->target > 0) {
-        Solution::best_score_wvcp = Parameters::p->target;
+        if (Parameters::p->use_target and Parameters::p->target > 0) {
+            atomic_min(Solution::best_score_wvcp, Parameters::p->target);
+        }
+    }
+    if (_tree != this) {
+        // share the tree of the main MCTS
+        _base_solution = _tree->_base_solution;
+        _base_hash = _tree->_base_hash;
+        _root_node = _tree->_root_node;
+        return;
     }
     // Creation of the base solution and root node
     const auto next_moves{next_possible_moves(_base_solution)};
     assert(next_moves.size() == 1);
-    apply_action(_base_solution, next_moves[0]);
+    apply_action(_base_solution, next_moves[0], _base_hash);
     const auto next_possible_actions{next_possible_moves(_base_solution)};
-    _root_node = std::make_shared<Node>(nullptr, next_moves[0], next_possible_actions);
-
-    fmt::print(Parameters::p->output, "{}", header_csv());
+    _root_node = Node::create_root(next_moves[0], next_possible_actions);
+    _pruning_score = _main->_best_score.load();
 }
 
 MCTS::~MCTS() {
-    _current_node = nullptr;
-    _root_node->clean_graph(0);
-    _root_node = nullptr;
+    if (_tree == this) {
+        Node::delete_tree(_root_node);
+    }
 }
 
 bool MCTS::stop_condition() const {
-    return (_turn < Parameters::p->nb_max_iterations) and
+    return (_main->_turn < Parameters::p->nb_max_iterations) and
            (not Parameters::p->time_limit_reached()) and
            not(Parameters::p->objective == "reached" and
-               (_best_solution.score_wvcp() <= Parameters::p->target)) and
-           not _root_node->fully_explored();
+               (_main->_best_score <= Parameters::p->target)) and
+           not _main->_tree_explored and not Node::get(_root_node.index).fully_explored();
 }
 
 void MCTS::run() {
+    fmt::print(Parameters::p->output, "{}", header_csv());
+    std::vector<std::thread> workers;
+    for (int worker_id{1}; worker_id < Parameters::p->nb_threads; ++worker_id) {
+        workers.emplace_back([this, worker_id]() {
+            // each worker has its own random generator and solutions
+            rd::seed(Parameters::p->rand_seed, worker_id);
+            MCTS worker(this);
+            worker.search();
+        });
+    }
+    search();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    _current_depth = 0;
+    fmt::print(Parameters::p->output, "{}", line_csv());
+}
+
+void MCTS::search() {
     SimulationHelper helper;
+    const size_t pool_size{static_cast<size_t>(Parameters::p->local_search_pool)};
     while (stop_condition()) {
+        if (pool_size > 0 and _suspended_searches.size() >= pool_size) {
+            resume_local_search();
+            continue;
+        }
 
-        _current_node = _root_node;
-        _current_solution = _base_solution;
+        _branch.clear();
+        _branch.push_back(_root_node);
+        _current_depth = 0;
+        // undo the changes of the last turn, or copy the base solution if the changes
+        // weren't recorded (too many changes or solution replaced by the local search)
+        if (not _current_solution.rollback()) {
+            _current_solution = _base_solution;
+            _current_solution.set_checkpoint();
+        }
+        _current_hash = _base_hash;
 
-        selection();
+        if (not selection()) {
+            for (size_t i{1}; i < _branch.size(); ++i) {
+                Node::remove_virtual_loss(_branch[i]);
+            }
+            // the other threads (or the suspended local searches) hold or prune the
+            // branches, let them progress before retrying
+            if (_suspended_searches.empty()) {
+                std::this_thread::yield();
+            } else {
+                resume_local_search();
+            }
+            continue;
+        }
 
         expansion();
 
-        // simulation
-        _initialization(_current_solution);
-
-        if (_simulation) {
-            // if the simulation is depth/fit/depth_fit
-            _simulation(_current_solution, _local_search, helper);
-        } else if (_local_search) {
-            // if the simulation is a simple local search
-            _local_search(_current_solution, false);
-        }
-
-        const int score_wvcp{_current_solution.score_wvcp()};
-        // update
-        _current_node->update(score_wvcp);
-        if (_best_solution.score_wvcp() > score_wvcp) {
-            _t_best = std::chrono::high_resolution_clock::now();
-            _best_solution = _current_solution;
-            if (Solution::best_score_wvcp > score_wvcp)
-                Solution::best_score_wvcp = score_wvcp;
+        // the partial colorations already simulated (by another thread or before a
+        // shrink of the tree) reuse the score of their simulation
+        int score_wvcp{0};
+        const bool simulated{not _main->_transpositions.find(_current_hash, score_wvcp)};
+        if (simulated and pool_size > 0) {
+            // the branch is updated at the end of the local search
+            launch_local_search();
+            ++_main->_turn;
+            continue;
+        }
+        if (simulated) {
+            simulation(helper);
+            score_wvcp = _current_solution.score_wvcp();
+            _main->_transpositions.store(_current_hash, score_wvcp);
+        }
+        backpropagation(_branch, _current_solution, score_wvcp, simulated);
+        ++_main->_turn;
+    }
+    finish_local_searches();
+    if (Node::get(_root_node.index).fully_explored()) {
+        _main->_tree_explored = true;
+    }
+}
+
+void MCTS::simulation(SimulationHelper &helper) {
+    _initialization(_current_solution);
+
+    int selected{-1};
+    if (_main->_selector->active()) {
+        selected = _main->_selector->select();
+        _local_search = _main->_selector->local_search_fct(selected);
+    }
+    const int score_before{_current_solution.score_wvcp()};
+    const size_t nb_past_solutions{helper.past_solutions.size()};
+    const auto simulation_start{std::chrono::high_resolution_clock::now()};
+
+    if (_simulation) {
+        // if the simulation is depth/fit/depth_fit
+        _simulation(_current_solution, _local_search, _workspace, helper);
+    } else if (_local_search) {
+        // if the simulation is a simple local search
+        _local_search(_current_solution, _workspace, false);
+    }
+
+    // depth/fit/depth_fit only call the local search on the solutions they add to
+    // the past solutions
+    if (selected != -1 and
+        (not _simulation or helper.past_solutions.size() > nb_past_solutions)) {
+        reward_local_search(selected, score_before, simulation_start);
+    }
+}
+
+void MCTS::launch_local_search() {
+    _initialization(_current_solution);
+    auto suspended{std::make_unique<SuspendedLocalSearch>()};
+    suspended->solution = _current_solution;
+    suspended->branch = _branch;
+    suspended->hash = _current_hash;
+    suspended->search = make_local_search(
+        Parameters::p->local_search, suspended->solution, suspended->workspace, false);
+    _suspended_searches.push_back(std::move(suspended));
+}
+
+void MCTS::resume_local_search() {
+    if (_next_search >= _suspended_searches.size()) {
+        _next_search = 0;
+    }
+    SuspendedLocalSearch &suspended{*_suspended_searches[_next_search]};
+    const int score_before{suspended.solution.score_wvcp()};
+    const bool resumable{suspended.search->step(Parameters::p->local_search_slice)};
+    const int score_wvcp{suspended.solution.score_wvcp()};
+    // a search that stopped improving is given up if the other searches are better
+    const bool unpromising{
+        score_wvcp == score_before and _suspended_searches.size() > 1 and
+        std::all_of(_suspended_searches.begin(),
+                    _suspended_searches.end(),
+                    [&suspended, score_wvcp](const auto &other) {
+                        return other.get() == &suspended or
+                               other->solution.score_wvcp() < score_wvcp;
+                    })};
+    if (resumable and not unpromising) {
+        if (_main->_best_score > score_wvcp) {
+            share_solution(suspended.solution);
+        }
+        ++_next_search;
+        return;
+    }
+    _main->_transpositions.store(suspended.hash, score_wvcp);
+    backpropagation(suspended.branch, suspended.solution, score_wvcp, true);
+    // the next search takes the place of the ended one
+    _suspended_searches.erase(_suspended_searches.begin() +
+                              static_cast<std::ptrdiff_t>(_next_search));
+}
+
+void MCTS::finish_local_searches() {
+    for (const auto &suspended : _suspended_searches) {
+        suspended->search->run();
+        const int score_wvcp{suspended->solution.score_wvcp()};
+        _main->_transpositions.store(suspended->hash, score_wvcp);
+        backpropagation(suspended->branch, suspended->solution, score_wvcp, true);
+    }
+    _suspended_searches.clear();
+    _next_search = 0;
+}
+
+void MCTS::backpropagation(const std::vector<NodeLink> &branch,
+                           const Solution &solution,
+                           const int score_wvcp,
+                           const bool simulated) {
+    // update the branch from the leaf to the root
+    for (size_t i{branch.size()}; i-- > 0;) {
+        const NodeLink child{i + 1 < branch.size() ? branch[i + 1] : NodeLink{}};
+        Node::update(branch[i], child, score_wvcp, i > 0);
+    }
+    if (simulated and _main->_best_score > score_wvcp) {
+        share_solution(solution);
+    }
+    shrink_tree();
+    // prune the tree with the best score found by all the threads (only one thread
+    // prunes a shared tree), or by all the workers of the portfolio
+    int best_score{_main->_best_score};
+    if (_main->_portfolio) {
+        best_score = std::min(best_score, _main->_portfolio->best_score());
+    }
+    int pruning_score{_tree->_pruning_score};
+    if (best_score < pruning_score and
+        _tree->_pruning_score.compare_exchange_strong(pruning_score, best_score)) {
+        Node::get(_root_node.index).clean_graph(best_score);
+    }
+}
+
+void MCTS::share_solution(const Solution &solution) {
+    const std::lock_guard<std::mutex> lock(_main->_best_mutex);
+    const int score_wvcp{solution.score_wvcp()};
+    if (_main->_best_solution.score_wvcp() > score_wvcp) {
+        _main->_t_best = std::chrono::high_resolution_clock::now();
+        _main->_best_solution = solution;
+        _main->_best_score = score_wvcp;
+        atomic_min(Solution::best_score_wvcp, score_wvcp);
+        if (_main->_portfolio) {
+            _main->_portfolio->share_solution(
+                solution, _main->_portfolio_worker, _main->_turn);
+        } else {
             fmt::print(Parameters::p->output, "{}", line_csv());
-            _current_node = nullptr;
-            _root_node->clean_graph(_best_solution.score_wvcp());
         }
-        _current_node = nullptr;
-        ++_turn;
     }
-    _current_node = _root_node;
-    fmt::print(Parameters::p->output, "{}", line_csv());
-    _current_node = nullptr;
-}
-
-void MCTS::selection() {
-    while (not _current_node->terminal()) {
-        double max_score{std::numeric_limits<double>::min()};
-        std::vector<std::shared_ptr<Node>> next_nodes;
-        for (const auto &node : _current_node->children_nodes()) {
-            if (node->score_ucb() > max_score) {
-                max_score = node->score_ucb();
-                next_nodes = {node};
-            } else if (node->score_ucb() == max_score) {
-                next_nodes.push_back(node);
-            }
+}
+
+void MCTS::share_with(Portfolio *portfolio, const int worker) {
+    _portfolio = portfolio;
+    _portfolio_worker = worker;
+}
+
+[[nodiscard]] bool MCTS::tree_explored() const {
+    return _main->_tree_explored;
+}
+
+void MCTS::reward_local_search(
+    const int selected,
+    const int score_before,
+    const std::chrono::high_resolution_clock::time_point &start) {
+    const auto now{std::chrono::high_resolution_clock::now()};
+    const std::chrono::duration<double> duration{now - start};
+    const double gain_rate{static_cast<double>(score_before -
+                                               _current_solution.score_wvcp()) /
+                           std::max(duration.count(), 1e-6)};
+    _main->_selector->reward(selected, gain_rate);
+    _selection_csv = fmt::format("{},{},{}",
+                                 _main->_selector->name(selected),
+                                 gain_rate,
+                                 Parameters::p->elapsed_time_ms(now));
+}
+
+[[nodiscard]] long MCTS::max_tree_nodes() const {
+    long max_nodes{std::numeric_limits<long>::max()};
+    if (Parameters::p->max_tree_nodes > 0) {
+        max_nodes = Parameters::p->max_tree_nodes;
+    }
+    if (Parameters::p->max_tree_memory > 0) {
+        // the slots of the pool are reused so the memory grows with the number of nodes
+        const long node_memory{Node::get_memory() /
+                               std::max(1L, Node::get_nb_allocated_nodes())};
+        max_nodes = std::min(max_nodes,
+                             Parameters::p->max_tree_memory * 1024 * 1024 /
+                                 std::max(1L, node_memory));
+    }
+    if (Parameters::p->parallel == "root") {
+        max_nodes /= Parameters::p->nb_threads;
+    }
+    return max_nodes;
+}
+
+void MCTS::shrink_tree() {
+    const long max_nodes{max_tree_nodes()};
+    if (_tree->_nb_tree_nodes <= max_nodes or not _tree->_shrink_mutex.try_lock()) {
+        return;
+    }
+    // shrink a bit more than needed to avoid shrinking at each turn
+    const long nb_nodes{_tree->_nb_tree_nodes};
+    const long nb_remaining_nodes{
+        Node::shrink_tree(_root_node, std::max(1L, max_nodes - max_nodes / 10))};
+    // the nodes created by other threads during the shrink are kept in the count
+    _tree->_nb_tree_nodes -= nb_nodes - nb_remaining_nodes;
+    _tree->_shrink_mutex.unlock();
+}
+
+bool MCTS::selection() {
+    while (true) {
+        const NodeLink &current_node{_branch.back()};
+        Node &node{Node::get(current_node.index)};
+        const std::lock_guard<std::mutex> lock(node.mutex());
+        if (not Node::exists(current_node)) {
+            // another thread deleted the branch
+            return false;
+        }
+        if (node.terminal()) {
+            _next_move = node.next_child();
+            return true;
         }
-        _current_node = rd::choice(next_nodes);
-        apply_action(_current_solution, _current_node->move());
+        const NodeLink next_node{node.best_child()};
+        if (next_node.index == -1) {
+            return false;
+        }
+        // the move and the depth of the child are read while its parent is locked
+        Node &child{Node::get(next_node.index)};
+        _branch.push_back(next_node);
+        _current_depth = child.get_depth();
+        apply_action(_current_solution, child.move(), _current_hash);
     }
 }
 
 void MCTS::expansion() {
-    const Action next_move{_current_node->next_child()};
-    apply_action(_current_solution, next_move);
+    apply_action(_current_solution, _next_move, _current_hash);
     const auto next_possible_actions{next_possible_moves(_current_solution)};
     if (not next_possible_actions.empty()) {
-        _current_node =
-            std::make_shared<Node>(_current_node.get(), next_move, next_possible_actions);
-        _current_node->add_child_to_parent(_current_node);
+        const NodeLink child{
+            Node::add_child(_branch.back(), _next_move, next_possible_actions)};
+        if (child.index != -1) {
+            _branch.push_back(child);
+            ++_current_depth;
+            ++_tree->_nb_tree_nodes;
+        }
+    } else {
+        Node::end_expansion(_branch.back());
     }
 }
 
 [[nodiscard]] const std::string MCTS::header_csv() const {
     return fmt::format("date,{},turn,time,depth,nb total node,nb "
-                       "current node,height,{}\n",
+                       "current node,height,{}{}\n",
                        Parameters::p->header_csv,
+                       _main->_selector->active()
+                           ? "local_search_selected,local_search_gain_rate,"
+                             "local_search_time_ms,"
+                           : "",
                        Solution::header_csv);
 }
 
 [[nodiscard]] const std::string MCTS::line_csv() const {
-    return fmt::format("{},{},{},{},{},{},{},{},{}\n",
+    return fmt::format("{},{},{},{},{},{},{},{},{}{}\n",
                        get_date_str(),
                        Parameters::p->line_csv,
-                       _turn,
-                       Parameters::p->elapsed_time(_t_best),
-                       _current_node->get_depth(),
+                       _main->_turn,
+                       Parameters::p->elapsed_time(_main->_t_best),
+                       _current_depth,
                        Node::get_total_nodes(),
                        Node::get_nb_current_nodes(),
                        Node::get_height(),
-                       _best_solution.line_csv());
+                       _main->_selector->active() ? _selection_csv + "," : "",
+                       _main->_best_solution.line_csv());
 }
 
 std::vector<Action> next_possible_moves(const Solution &solution) {
@@ -176,7 +437,19 @@ std::vector<Action> next_possible_moves(const Solution &solution) {
     return moves;
 }
 
-void apply_action(Solution &solution, const Action &action) {
+void apply_action(Solution &solution, const Action &action, uint64_t &hash) {
+    // a color class is identified by its lowest vertex, as the numbers of the colors
+    // depend on the order of the moves. The MCTS colors the vertices by increasing
+    // number and its rollbacks put the vertices back at their positions, so the lowest
+    // vertex stays the first one of the class (only a deletion in the middle of the
+    // class, never done here, would move it)
+    assert(action.color == -1 or
+           *std::min_element(solution.colors_vertices(action.color).begin(),
+                             solution.colors_vertices(action.color).end()) ==
+               solution.colors_vertices(action.color)[0]);
+    hash ^= TranspositionTable::key(
+        action.vertex,
+        action.color == -1 ? action.vertex : solution.colors_vertices(action.color)[0]);
     solution.add_to_color(action.vertex, action.color);
     assert(solution.first_free_vertex() == action.vertex);
     solution.increment_first_free_vertex();
@@ -186,13 +459,14 @@ void apply_action(Solution &solution, const Action &action) {
 void MCTS::to_dot(const std::string &file_name) const {
     if ((_turn % 5) == 0) {
         std::ofstream file{file_name};
-        file << _root_node->to_dot();
+        file << Node::get(_root_node.index).to_dot();
         file.close();
     }
 }
 
 void fit(Solution &solution,
          const local_search_ptr &local_search,
+         LocalSearchWorkspace &workspace,
          SimulationHelper &helper) {
     if (solution.score_wvcp() <= (helper.fit_condition + 1)) {
         if (std::all_of(helper.past_solutions.begin(),
@@ -203,17 +477,17 @@ void fit(Solution &solution,
                         })) {
             helper.past_solutions.push_back(solution);
             helper.fit_condition = std::min(solution.score_wvcp(), helper.fit_condition);
-            local_search(solution, false);
+            local_search(solution, workspace, false);
         }
     }
 }
 
 void depth(Solution &solution,
            const local_search_ptr &local_search,
+           LocalSearchWorkspace &workspace,
            SimulationHelper &helper) {
-    std::uniform_int_distribution<int> distribution(0, 100);
     if ((solution.first_free_vertex() * 100) / Graph::g->nb_vertices >=
-        distribution(rd::generator)) {
+        rd::uniform(0, 100)) {
         if (std::all_of(helper.past_solutions.begin(),
                         helper.past_solutions.end(),
                         [solution](Solution sol) {
@@ -221,18 +495,18 @@ void depth(Solution &solution,
                                    Graph::g->nb_vertices / 10;
                         })) {
             helper.past_solutions.push_back(solution);
-            local_search(solution, false);
+            local_search(solution, workspace, false);
         }
     }
 }
 
 void depth_fit(Solution &solution,
                const local_search_ptr &local_search,
+               LocalSearchWorkspace &workspace,
                SimulationHelper &helper) {
-    std::uniform_int_distribution<int> distribution(0, 100);
     if (solution.score_wvcp() <= (helper.fit_condition + 1) and
         (solution.first_free_vertex() * 100) / Graph::g->nb_vertices <=
-            distribution(rd::generator)) {
+            rd::uniform(0, 100)) {
         if (std::all_of(helper.past_solutions.begin(),
                         helper.past_solutions.end(),
                         [solution](Solution sol) {
@@ -241,7 +515,7 @@ void depth_fit(Solution &solution,
                         })) {
             helper.past_solutions.push_back(solution);
             helper.fit_condition = std::min(solution.score_wvcp(), helper.fit_condition);
-            local_search(solution, false);
+            local_search(solution, workspace, false);
         }
     }
 }
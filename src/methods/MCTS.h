@@ -1,18 +1,48 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 #include "../representation/Method.h"
 #include "../representation/Node.h"
 #include "../representation/Parameters.h"
 #include "../representation/Solution.h"
+#include "../representation/TranspositionTable.h"
 #include "LocalSearch.h"
+#include "LocalSearchSelector.h"
+
+class Portfolio;
 
 struct SimulationHelper {
     int fit_condition{std::numeric_limits<int>::max() - 1};
     std::vector<Solution> past_solutions{};
 };
 
+/**
+ * @brief Local search of a simulation suspended between its steps, with the branch of
+ * the simulated node to update at its end
+ *
+ */
+struct SuspendedLocalSearch {
+    /** @brief Solution of the simulation, replaced by the best one of the search*/
+    Solution solution;
+    /** @brief Nodes from the root node to the simulated node (the nodes after the root
+     * keep their virtual loss until the end of the search)*/
+    std::vector<NodeLink> branch;
+    /** @brief Hash of the partial coloration of the simulated node*/
+    uint64_t hash{0};
+    /** @brief Buffers of the search*/
+    LocalSearchWorkspace workspace{};
+    /** @brief The search, using the solution and the workspace*/
+    std::unique_ptr<ResumableLocalSearch> search{};
+};
+
 /** @brief Pointer to simulation function*/
-typedef void (*simulation_ptr)(Solution &, const local_search_ptr &, SimulationHelper &);
+typedef void (*simulation_ptr)(Solution &,
+                               const local_search_ptr &,
+                               LocalSearchWorkspace &,
+                               SimulationHelper &);
 
 /**
  * @brief Get the simulation function
@@ -25,36 +55,102 @@ simulation_ptr get_simulation_fct(const std::string &simulation);
 /**
  * @brief Method for Monte Carlo Tree Search
  *
+ * With more than one thread, the main MCTS starts workers with their own solutions and
+ * random generator. With the root parallelization, each worker builds its own tree and
+ * prunes it when another thread finds a better solution. With the tree parallelization,
+ * the workers share the tree of the main MCTS and use virtual losses to spread across
+ * the branches. The workers share the best solution, the number of turns and the stop
+ * of the search with the main MCTS.
+ *
+ * With local_search_pool, each thread suspends the local searches of its simulations
+ * and resumes them in turn, the branch of a simulation is updated at the end of its
+ * search.
+ *
  */
 class MCTS : public Method {
   private:
+    /** @brief Main MCTS of the search (itself for the main MCTS)*/
+    MCTS *_main;
+    /** @brief MCTS owning the tree (the main MCTS with the tree parallelization, itself
+     * otherwise)*/
+    MCTS *_tree;
     /** @brief Root node of the MCTS*/
-    std::shared_ptr<Node> _root_node;
-    /** @brief Current node*/
-    std::shared_ptr<Node> _current_node;
-    /** @brief Solution at the beginning of the tree (will be copied at each turn)*/
+    NodeLink _root_node;
+    /** @brief Nodes of the current turn from the root node to the current node (the
+     * nodes after the root have a virtual loss)*/
+    std::vector<NodeLink> _branch;
+    /** @brief Depth of the current node*/
+    int _current_depth{0};
+    /** @brief Move to expand, given by the selection*/
+    Action _next_move{};
+    /** @brief Solution at the beginning of the tree (copied when the current solution
+     * can't be rolled back)*/
     Solution _base_solution;
     /** @brief Best found solution*/
     Solution _best_solution;
-    /** @brief Current solution*/
+    /** @brief Current solution (rolled back to the base solution at each turn)*/
     Solution _current_solution;
-    /** @brief Current turn of MCTS*/
-    long _turn{};
-    /** @brief Time before founding best score*/
-    std::chrono::high_resolution_clock::time_point _t_best{};
+    /** @brief Hash of the partial coloration of the base solution*/
+    uint64_t _base_hash{0};
+    /** @brief Hash of the partial coloration of the current solution*/
+    uint64_t _current_hash{0};
+    /** @brief Current turn of MCTS (turns of all threads, only used on the main MCTS)*/
+    std::atomic<long> _turn{};
+    /** @brief Score of the best solution (only used on the main MCTS)*/
+    std::atomic<int> _best_score{};
+    /** @brief True when a thread proved the optimality (only used on the main MCTS)*/
+    std::atomic<bool> _tree_explored{false};
+    /** @brief Protect the best solution and the output (only used on the main MCTS)*/
+    std::mutex _best_mutex;
+    /** @brief Score used for the last pruning of the tree (only used on the MCTS owning
+     * the tree)*/
+    std::atomic<int> _pruning_score{};
+    /** @brief Upper bound of the number of nodes of the tree, exact after a shrink of
+     * the tree (only used on the MCTS owning the tree)*/
+    std::atomic<long> _nb_tree_nodes{1};
+    /** @brief Taken by the thread shrinking the tree (only used on the MCTS owning the
+     * tree)*/
+    std::mutex _shrink_mutex;
+    /** @brief Time before founding best score (start of the search while no solution
+     * was found)*/
+    std::chrono::high_resolution_clock::time_point _t_best{Parameters::p->time_start};
     /** @brief Function to call for initialize the solutions*/
     init_ptr _initialization;
     /** @brief Function to call as local search*/
     local_search_ptr _local_search;
     /** @brief Function to call for simulation*/
     simulation_ptr _simulation;
+    /** @brief Buffers of the local searches of the thread, reused by each simulation*/
+    LocalSearchWorkspace _workspace;
+    /** @brief Selection of the local search of the simulations (only constructed by
+     * the main MCTS, shared by the threads through _main)*/
+    std::unique_ptr<LocalSearchSelector> _selector;
+    /** @brief Last local search selected by the thread, its improvement of the score
+     * per second and the time of the decision (milliseconds since the start of the
+     * search) in csv format, printed with the new best solutions and the final line*/
+    std::string _selection_csv{"none,0,0"};
+    /** @brief Scores of the simulations of the partial colorations (only used on the
+     * main MCTS)*/
+    TranspositionTable _transpositions;
+    /** @brief Local searches of the simulations of the thread suspended between their
+     * steps (with local_search_pool)*/
+    std::vector<std::unique_ptr<SuspendedLocalSearch>> _suspended_searches;
+    /** @brief Index of the next suspended local search to resume*/
+    size_t _next_search{0};
+    /** @brief Portfolio receiving the best found solutions instead of the output, if
+     * the MCTS is a worker of a portfolio (only used on the main MCTS)*/
+    Portfolio *_portfolio{nullptr};
+    /** @brief Number of the worker of the MCTS in the portfolio*/
+    int _portfolio_worker{0};
 
   public:
     /**
      * @brief Construct a new MCTS object
      *
+     * @param main main MCTS of the search if the new MCTS is a worker thread, nullptr
+     * otherwise
      */
-    explicit MCTS();
+    explicit MCTS(MCTS *main = nullptr);
 
     ~MCTS();
 
@@ -68,16 +164,76 @@ class MCTS : public Method {
     bool stop_condition() const;
 
     /**
-     * @brief Run the 4 phases of MCTS algorithm until stop condition
+     * @brief Run the search with the given number of threads and print the results
      *
      */
     void run() override;
 
+    /**
+     * @brief Run the 4 phases of MCTS algorithm until stop condition
+     *
+     */
+    void search();
+
+    /**
+     * @brief Share the solution with the main MCTS if it is the best found solution of
+     * the search
+     *
+     * @param solution solution of a simulation of the thread
+     */
+    void share_solution(const Solution &solution);
+
+    /**
+     * @brief Give the best found solutions to the portfolio instead of printing them
+     *
+     * @param portfolio the portfolio
+     * @param worker number of the worker of the MCTS in the portfolio
+     */
+    void share_with(Portfolio *portfolio, const int worker);
+
+    /**
+     * @brief Return true if the tree has been fully explored (no better solution than
+     * the shared best score)
+     *
+     * @return true the tree has been fully explored
+     * @return false the search stopped before
+     */
+    [[nodiscard]] bool tree_explored() const;
+
+    /**
+     * @brief Reward the selected local search with its improvement of the current
+     * solution per second and record the decision in _selection_csv
+     *
+     * @param selected index of the local search in the selector
+     * @param score_before score of the current solution before the local search
+     * @param start time of the start of the local search
+     */
+    void reward_local_search(const int selected,
+                             const int score_before,
+                             const std::chrono::high_resolution_clock::time_point &start);
+
+    /**
+     * @brief Return the maximal number of nodes of the tree according to the limits of
+     * nodes and memory (shared between the trees with the root parallelization)
+     *
+     * @return long maximal number of nodes
+     */
+    [[nodiscard]] long max_tree_nodes() const;
+
+    /**
+     * @brief Collapse the least visited branches of the tree if the tree is too big
+     *
+     */
+    void shrink_tree();
+
     /**
      * @brief Selection phase of the MCTS algorithm
      *
+     * @return true a move to expand has been found
+     * @return false the selection reached a node without possible move and child (the
+     * other threads explored the branch)
      */
-    void selection();
+    bool selection();
 
     /**
      * @brief Expansion phase of the MCTS algorithm
@@ -85,6 +241,50 @@ class MCTS : public Method {
      */
     void expansion();
 
+    /**
+     * @brief Simulation phase of the MCTS algorithm
+     *
+     * @param helper past solutions and fit condition of the simulations
+     */
+    void simulation(SimulationHelper &helper);
+
+    /**
+     * @brief Start the local search of the simulation of the current node and suspend
+     * it with the current branch (with local_search_pool)
+     *
+     */
+    void launch_local_search();
+
+    /**
+     * @brief Resume the next suspended local search for local_search_slice turns, then
+     * end its simulation if the search is over or if its step didn't improve it while
+     * it is the worst suspended search
+     *
+     */
+    void resume_local_search();
+
+    /**
+     * @brief Run the suspended local searches until their end and end their simulations
+     *
+     */
+    void finish_local_searches();
+
+    /**
+     * @brief Backpropagation phase of the MCTS algorithm, update the branch with the
+     * score of the simulation, share the simulated solution if it is the best one then
+     * shrink and prune the tree
+     *
+     * @param branch nodes from the root node to the simulated node
+     * @param solution solution of the simulation
+     * @param score_wvcp score of the simulation
+     * @param simulated true if the solution was simulated (false if the score was found
+     * in the transposition table)
+     */
+    void backpropagation(const std::vector<NodeLink> &branch,
+                         const Solution &solution,
+                         const int score_wvcp,
+                         const bool simulated);
+
     /**
      * @brief Return string of the MCTS csv format
      *
@@ -118,8 +318,9 @@ std::vector<Action> next_possible_moves(const Solution &solution);
  * @brief Apply a move to the solution
  *
  * @param mv move to apply
+ * @param hash hash of the partial coloration of the solution, updated with the move
  */
-void apply_action(Solution &solution, const Action &action);
+void apply_action(Solution &solution, const Action &action, uint64_t &hash);
 
 /**
  * @brief Apply the greedy on the solution and allow to do a local search if the fitness
@@ -127,9 +328,12 @@ void apply_action(Solution &solution, const Action &action);
  *
  * @param solution solution to use, the solution will be modified
  * @param local_search local search to use
+ * @param workspace buffers of the local search
+ * @param helper past solutions and fit condition of the simulations
  */
 void fit(Solution &solution,
          const local_search_ptr &local_search,
+         LocalSearchWorkspace &workspace,
          SimulationHelper &helper);
 
 /**
@@ -138,9 +342,12 @@ void fit(Solution &solution,
  *
  * @param solution solution to use, the solution will be modified
  * @param local_search local search to use
+ * @param workspace buffers of the local search
+ * @param helper past solutions and fit condition of the simulations
  */
 void depth(Solution &solution,
            const local_search_ptr &local_search,
+           LocalSearchWorkspace &workspace,
            SimulationHelper &helper);
 
 /**
@@ -150,7 +357,10 @@ void depth(Solution &solution,
  *
  * @param solution solution to use, the solution will be modified
  * @param local_search local search to use
+ * @param workspace buffers of the local search
+ * @param helper past solutions and fit condition of the simulations
  */
 void depth_fit(Solution &solution,
                const local_search_ptr &local_search,
+               LocalSearchWorkspace &workspace,
                SimulationHelper &helper);
@@ -0,0 +1,118 @@
+#include "Portfolio.h"
+
+#include <thread>
+
+#include "../representation/Parameters.h"
+#include "../utils/random_generator.h"
+#include "../utils/utils.h"
+#include "LocalSearch.h"
+#include "LocalSearchWorkspace.h"
+#include "MCTS.h"
+#include "greedy.h"
+
+Portfolio::Portfolio() : _best_solution() {
+    const auto searches{split_string(Parameters::p->portfolio, ":")};
+    for (const auto &search : searches) {
+        if (search != "mcts" and not get_local_search_fct(search)) {
+            fmt::print(stderr,
+                       "The searches of the portfolio must be separated by ':' and be "
+                       "mcts or a local search (not none)\n");
+            exit(1);
+        }
+    }
+    // the searches are given to the workers in turn
+    for (size_t worker{0}; worker < static_cast<size_t>(Parameters::p->nb_threads);
+         ++worker) {
+        _workers.push_back(searches[worker % searches.size()]);
+    }
+    greedy_worst(_best_solution);
+    _best_score = _best_solution.score_wvcp();
+}
+
+void Portfolio::run() {
+    fmt::print(Parameters::p->output, "{}", header_csv());
+    std::vector<std::thread> threads;
+    for (int worker{1}; worker < static_cast<int>(_workers.size()); ++worker) {
+        threads.emplace_back([this, worker]() {
+            // each worker has its own random generator
+            rd::seed(Parameters::p->rand_seed, worker);
+            run_worker(worker);
+        });
+    }
+    run_worker(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    fmt::print(Parameters::p->output, "{}", line_csv());
+}
+
+void Portfolio::run_worker(const int worker) {
+    if (_workers[worker] == "mcts") {
+        MCTS mcts;
+        mcts.share_with(this, worker);
+        mcts.search();
+        if (mcts.tree_explored()) {
+            // no better solution than the shared best score exists
+            stop_workers();
+        }
+        return;
+    }
+    const init_ptr initialization{get_initialization_fct(Parameters::p->initialization)};
+    const local_search_ptr local_search{get_local_search_fct(_workers[worker])};
+    LocalSearchWorkspace workspace;
+    long nb_starts{0};
+    while (nb_starts < Parameters::p->nb_max_iterations and
+           not Parameters::p->time_limit_reached()) {
+        ++nb_starts;
+        Solution solution;
+        initialization(solution);
+        local_search(solution, workspace, false);
+        share_solution(solution, worker, nb_starts);
+    }
+}
+
+void Portfolio::stop_workers() {
+    // same as the interruption of the search by a signal
+    Parameters::p->stop_search();
+}
+
+void Portfolio::share_solution(const Solution &solution,
+                               const int worker,
+                               const long turn) {
+    const std::lock_guard<std::mutex> lock(_best_mutex);
+    const int score_wvcp{solution.score_wvcp()};
+    if (solution.penalty() != 0 or _best_solution.score_wvcp() <= score_wvcp) {
+        return;
+    }
+    _t_best = std::chrono::high_resolution_clock::now();
+    _best_solution = solution;
+    _best_score = score_wvcp;
+    _best_worker = worker;
+    _best_turn = turn;
+    atomic_min(Solution::best_score_wvcp, score_wvcp);
+    fmt::print(Parameters::p->output, "{}", line_csv());
+    if (Parameters::p->objective == "reached" and score_wvcp <= Parameters::p->target) {
+        stop_workers();
+    }
+}
+
+[[nodiscard]] int Portfolio::best_score() const {
+    return _best_score;
+}
+
+[[nodiscard]] const std::string Portfolio::header_csv() const {
+    return fmt::format("date,{},worker,search,turn,time,{}\n",
+                       Parameters::p->header_csv,
+                       Solution::header_csv);
+}
+
+[[nodiscard]] const std::string Portfolio::line_csv() const {
+    return fmt::format("{},{},{},{},{},{},{}\n",
+                       get_date_str(),
+                       Parameters::p->line_csv,
+                       _best_worker,
+                       _best_worker == -1 ? "none" : _workers[_best_worker],
+                       _best_turn,
+                       Parameters::p->elapsed_time(_t_best),
+                       _best_solution.line_csv());
+}
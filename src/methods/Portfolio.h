@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../representation/Method.h"
+#include "../representation/Parameters.h"
+#include "../representation/Solution.h"
+
+/**
+ * @brief Method running several searches at the same time on the same graph
+ *
+ * Each thread is a worker running the MCTS or restarting a local search from a new
+ * initial solution until the time limit or nb_max_iterations restarts, with its own
+ * random generator (see rd::seed). The workers share the best found solution : its
+ * score is the shared best score used by the MCTS to prune their trees, and the search
+ * stops for all the workers when the target is reached or when a MCTS proves the
+ * optimality.
+ *
+ */
+class Portfolio : public Method {
+
+    /** @brief For each worker, its search (mcts or the name of a local search)*/
+    std::vector<std::string> _workers{};
+    /** @brief Best found solution*/
+    Solution _best_solution;
+    /** @brief Score of the best found solution, read by the MCTS workers to prune their
+     * trees*/
+    std::atomic<int> _best_score{0};
+    /** @brief Worker that found the best solution*/
+    int _best_worker{-1};
+    /** @brief Turn of the worker when it found the best solution*/
+    long _best_turn{0};
+    /** @brief Time before founding best score (start of the search while no solution
+     * was found)*/
+    std::chrono::high_resolution_clock::time_point _t_best{Parameters::p->time_start};
+    /** @brief Protect the best solution and the output*/
+    std::mutex _best_mutex;
+
+    /**
+     * @brief Run the search of the worker until the end of the search
+     *
+     * @param worker number of the worker
+     */
+    void run_worker(const int worker);
+
+    /**
+     * @brief Stop all the workers
+     *
+     */
+    static void stop_workers();
+
+  public:
+    explicit Portfolio();
+
+    ~Portfolio() override = default;
+
+    /**
+     * @brief Run the workers and print the results
+     */
+    void run() override;
+
+    /**
+     * @brief Share the solution of a worker if it is the best found solution
+     *
+     * @param solution the solution
+     * @param worker number of the worker
+     * @param turn turn of the worker (turn of the MCTS or number of restarts of the local
+     * search)
+     */
+    void share_solution(const Solution &solution, const int worker, const long turn);
+
+    /**
+     * @brief Return the score of the best solution found by the workers
+     *
+     * @return int the best score
+     */
+    [[nodiscard]] int best_score() const;
+
+    /**
+     * @brief Return method header in csv format
+     *
+     * @return std::string method header in csv format
+     */
+    [[nodiscard]] const std::string header_csv() const override;
+
+    /**
+     * @brief Return method in csv format
+     *
+     * @return std::string method in csv format
+     */
+    [[nodiscard]] const std::string line_csv() const override;
+};
@@ -0,0 +1,59 @@
+#include "ResumableLocalSearch.h"
+
+#include <limits>
+
+#include "../representation/Parameters.h"
+#include "../utils/utils.h"
+
+ResumableLocalSearch::ResumableLocalSearch(Solution &best_solution, const bool verbose)
+    : _best_solution(best_solution),
+      _verbose(verbose),
+      _remaining_time(
+          std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+              std::chrono::duration<double>(Parameters::p->max_time_local_search))) {
+}
+
+[[nodiscard]] bool ResumableLocalSearch::can_continue() const {
+    return not _deadline.reached() and _turn < Parameters::p->nb_iter_local_search and
+           _best_solution.score_wvcp() != Parameters::p->target;
+}
+
+void ResumableLocalSearch::end() {
+    if (_verbose) {
+        print_result_ls(_best_time, _best_solution, _turn);
+    }
+}
+
+bool ResumableLocalSearch::step(const long nb_turns) {
+    const auto step_start{std::chrono::high_resolution_clock::now()};
+    _max_time = step_start + _remaining_time;
+    _deadline.reset(_max_time);
+    for (long i{0}; i < nb_turns and not _finished; ++i) {
+        if (not can_continue()) {
+            _finished = true;
+            end();
+            break;
+        }
+        ++_turn;
+        one_turn();
+    }
+    _remaining_time -= std::chrono::high_resolution_clock::now() - step_start;
+    return not _finished;
+}
+
+void ResumableLocalSearch::run() {
+    while (step(std::numeric_limits<long>::max())) {
+    }
+}
+
+[[nodiscard]] bool ResumableLocalSearch::finished() const {
+    return _finished;
+}
+
+[[nodiscard]] long ResumableLocalSearch::turn() const {
+    return _turn;
+}
+
+[[nodiscard]] const Solution &ResumableLocalSearch::best_solution() const {
+    return _best_solution;
+}
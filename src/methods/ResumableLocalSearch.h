@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+
+#include "../representation/Solution.h"
+#include "../utils/deadline.h"
+
+/**
+ * @brief Local search that can be suspended between its turns and resumed later
+ *
+ * step(nb_turns) runs at most nb_turns turns of the search then returns, the search
+ * stops when it reaches its number of turns (nb_iter_local_search), its time
+ * (max_time_local_search, counted only during the steps) or the target. A caller can
+ * keep several searches and share the time between them (each one must then use its own
+ * workspace and keep its solution alive).
+ *
+ * The best solution given at the construction is updated during the search.
+ *
+ */
+class ResumableLocalSearch {
+  protected:
+    /** @brief Best found solution, updated by the search*/
+    Solution &_best_solution;
+    /** @brief True if print csv line each time new best scores is found*/
+    const bool _verbose;
+    /** @brief Number of turns done*/
+    long _turn{0};
+    /** @brief Time of the last best found solution*/
+    int64_t _best_time{0};
+    /** @brief True when the search is over*/
+    bool _finished{false};
+    /** @brief Time left for the search*/
+    std::chrono::high_resolution_clock::duration _remaining_time;
+    /** @brief Time limit of the current step*/
+    std::chrono::high_resolution_clock::time_point _max_time{};
+    /** @brief Checks of the time limit of the current step (updated by the checks)*/
+    mutable Deadline _deadline;
+
+    /**
+     * @brief Return true if the search can do one more turn (by default, time, number
+     * of turns and target)
+     *
+     * @return true the search continues
+     * @return false the search is over
+     */
+    [[nodiscard]] virtual bool can_continue() const;
+
+    /**
+     * @brief Run one turn of the search, the turn is already counted, set _finished to
+     * stop the search without calling end
+     *
+     */
+    virtual void one_turn() = 0;
+
+    /**
+     * @brief Called when the search stops because can_continue returned false (by
+     * default, print the best solution if verbose)
+     *
+     */
+    virtual void end();
+
+  public:
+    ResumableLocalSearch() = delete;
+
+    /**
+     * @brief Construct the search
+     *
+     * @param best_solution solution to use, the solution will be modified
+     * @param verbose True if print csv line each time new best scores is found
+     */
+    ResumableLocalSearch(Solution &best_solution, const bool verbose);
+
+    ResumableLocalSearch(const ResumableLocalSearch &other) = delete;
+    ResumableLocalSearch &operator=(const ResumableLocalSearch &other) = delete;
+
+    virtual ~ResumableLocalSearch() = default;
+
+    /**
+     * @brief Run at most nb_turns turns of the search
+     *
+     * @param nb_turns maximal number of turns
+     * @return true the search can be resumed
+     * @return false the search is over
+     */
+    bool step(const long nb_turns);
+
+    /**
+     * @brief Run the search until its end
+     *
+     */
+    void run();
+
+    /**
+     * @brief Return true if the search is over
+     *
+     * @return true the search is over
+     * @return false the search can be resumed
+     */
+    [[nodiscard]] bool finished() const;
+
+    /**
+     * @brief Return the number of turns done
+     *
+     * @return long number of turns
+     */
+    [[nodiscard]] long turn() const;
+
+    /**
+     * @brief Return the best found solution
+     *
+     * @return const Solution& the best solution
+     */
+    [[nodiscard]] const Solution &best_solution() const;
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../representation/Solution.h"
+#include "LocalSearchWorkspace.h"
+#include "ResumableLocalSearch.h"
 
 /**
  * @brief afisa main algorithm with edits on the management of the tabu list
@@ -11,9 +13,49 @@
  * Information Sciences 466, 203–219. https://doi.org/10.1016/j.ins.2018.07.037
  *
  * @param solution solution to use, the solution will be modified but stay legal
+ * @param workspace buffers of the local search
  * @param verbose True if print csv line each time new best scores is found
  */
-void afisa(Solution &solution, const bool verbose = false);
+void afisa(Solution &solution,
+           LocalSearchWorkspace &workspace,
+           const bool verbose = false);
+
+
+/**
+ * @brief Resumable version of afisa (see ResumableLocalSearch)
+ *
+ */
+class Afisa : public ResumableLocalSearch {
+    /** @brief Buffers of the local search*/
+    LocalSearchWorkspace &_workspace;
+    /** @brief Best solution of afisa (can have conflicts)*/
+    Solution _best_afisa_sol;
+    /** @brief Coefficient of the penalty in the evaluation*/
+    int _penalty_coeff{1};
+    /** @brief Number of turns without improvement*/
+    int _no_improvement{0};
+    /** @brief Number of turns of the small perturbation*/
+    const long _small_perturbation;
+    /** @brief Number of turns of the large perturbation*/
+    const long _large_perturbation;
+    /** @brief Number of turns of the next perturbation*/
+    long _perturbation;
+    /** @brief Number of turns of the tabu phase*/
+    const long _nb_turn_tabu;
+
+    void one_turn() override;
+
+  public:
+    /**
+     * @brief Construct the search
+     *
+     * @param best_solution solution to use, the solution will be modified but stay
+     * legal
+     * @param workspace buffers of the local search
+     * @param verbose True if print csv line each time new best scores is found
+     */
+    Afisa(Solution &best_solution, LocalSearchWorkspace &workspace, const bool verbose);
+};
 
 /**
  * @brief Tabu search from afisa
@@ -25,6 +67,7 @@ void afisa(Solution &solution, const bool verbose = false);
  * @param turns number of turns of tabu
  * @param perturbation type of perturbation
  * @param max_time time limit for the local search
+ * @param workspace buffers of the local search
  */
 void afisa_tabu(Solution &solution,
                 const Solution &best_solution,
@@ -32,4 +75,5 @@ void afisa_tabu(Solution &solution,
                 const int &penalty_coeff,
                 const long &turns,
                 const Perturbation &perturbation,
-                const std::chrono::high_resolution_clock::time_point &max_time);
\ No newline at end of file
+                const std::chrono::high_resolution_clock::time_point &max_time,
+                LocalSearchWorkspace &workspace);
\ No newline at end of file
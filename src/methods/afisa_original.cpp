@@ -1,88 +1,80 @@
 #include "afisa_original.h"
 
+#include "../utils/best_move_selector.h"
+#include "../utils/deadline.h"
 #include "../utils/random_generator.h"
 #include "../utils/utils.h"
 
-void afisa_original(Solution &best_solution, const bool verbose) {
-    // best_solution stay legal during the search, its updated when a
-    // new best score with no penalty is found
-
-    auto max_time{std::chrono::high_resolution_clock::now() +
-                  std::chrono::seconds(Parameters::p->max_time_local_search)};
+void afisa_original(Solution &best_solution,
+                    LocalSearchWorkspace &workspace,
+                    const bool verbose) {
+    AfisaOriginal(best_solution, workspace, verbose).run();
+}
 
-    int64_t best_time{0};
-    std::uniform_int_distribution<int> distribution(0, 100);
-    // best_afisa_sol can have conflict between vertices
-    Solution best_afisa_sol = best_solution;
-    int penalty_coeff{1};
-    int no_improvement{0};
-    long turn_afisa{0};
-    const long small_perturbation{static_cast<long>(0.05 * Graph::g->nb_vertices)};
-    const long large_perturbation{static_cast<long>(0.5 * Graph::g->nb_vertices)};
-    long perturbation{small_perturbation};
-    const long nb_turn_tabu{Graph::g->nb_vertices * 10};
-    // main loop of the program
-    while (not Parameters::p->time_limit_reached_sub_method(max_time) and
-           turn_afisa < Parameters::p->nb_iter_local_search and
-           best_solution.score_wvcp() != Parameters::p->target) {
-        ++turn_afisa;
+AfisaOriginal::AfisaOriginal(Solution &best_solution,
+                             LocalSearchWorkspace &,
+                             const bool verbose)
+    : ResumableLocalSearch(best_solution, verbose),
+      _best_afisa_sol(best_solution),
+      _small_perturbation(static_cast<long>(0.05 * Graph::g->nb_vertices)),
+      _large_perturbation(static_cast<long>(0.5 * Graph::g->nb_vertices)),
+      _perturbation(_small_perturbation),
+      _nb_turn_tabu(Graph::g->nb_vertices * 10) {
+}
 
-        Solution solution = best_afisa_sol;
-        // tabu phase
-        afisa_original_tabu(solution,
-                            best_solution,
-                            best_afisa_sol,
-                            penalty_coeff,
-                            nb_turn_tabu,
-                            Perturbation::no_perturbation,
-                            max_time);
+void AfisaOriginal::one_turn() {
+    Solution solution = _best_afisa_sol;
+    // tabu phase
+    afisa_original_tabu(solution,
+                        _best_solution,
+                        _best_afisa_sol,
+                        _penalty_coeff,
+                        _nb_turn_tabu,
+                        Perturbation::no_perturbation,
+                        _max_time);
 
-        // if new best score found
-        if (best_afisa_sol.score_wvcp() < best_solution.score_wvcp() and
-            best_afisa_sol.penalty() == 0) {
-            best_solution = best_afisa_sol;
-            no_improvement = 0;
-            perturbation = small_perturbation;
-            if (verbose) {
-                best_time = Parameters::p->elapsed_time(
-                    std::chrono::high_resolution_clock::now());
-                print_result_ls(best_time, best_solution, turn_afisa);
-            }
-        } else {
-            // if this is a new best solution with the same score
-            if (best_afisa_sol.score_wvcp() == best_solution.score_wvcp() and
-                best_afisa_sol.penalty() == 0) {
-                best_solution = best_afisa_sol;
-            }
-            no_improvement++;
-            if (no_improvement == 50) {
-                perturbation = large_perturbation;
-            }
+    // if new best score found
+    if (_best_afisa_sol.score_wvcp() < _best_solution.score_wvcp() and
+        _best_afisa_sol.penalty() == 0) {
+        _best_solution = _best_afisa_sol;
+        _no_improvement = 0;
+        _perturbation = _small_perturbation;
+        if (_verbose) {
+            _best_time = Parameters::p->elapsed_time(
+                std::chrono::high_resolution_clock::now());
+            print_result_ls(_best_time, _best_solution, _turn);
         }
-
-        // adaptive adjustment
-        if (best_afisa_sol.penalty() != 0) {
-            ++penalty_coeff;
-        } else {
-            --penalty_coeff;
-            if (penalty_coeff <= 0) {
-                penalty_coeff = 1;
-            }
+    } else {
+        // if this is a new best solution with the same score
+        if (_best_afisa_sol.score_wvcp() == _best_solution.score_wvcp() and
+            _best_afisa_sol.penalty() == 0) {
+            _best_solution = _best_afisa_sol;
+        }
+        _no_improvement++;
+        if (_no_improvement == 50) {
+            _perturbation = _large_perturbation;
         }
-
-        // perturbation phase
-        afisa_original_tabu(solution,
-                            best_solution,
-                            best_afisa_sol,
-                            penalty_coeff,
-                            perturbation,
-                            (distribution(rd::generator) < 50 ? Perturbation::no_tabu
-                                                              : Perturbation::unlimited),
-                            max_time);
     }
-    if (verbose) {
-        print_result_ls(best_time, best_solution, turn_afisa);
+
+    // adaptive adjustment
+    if (_best_afisa_sol.penalty() != 0) {
+        ++_penalty_coeff;
+    } else {
+        --_penalty_coeff;
+        if (_penalty_coeff <= 0) {
+            _penalty_coeff = 1;
+        }
     }
+
+    // perturbation phase
+    afisa_original_tabu(solution,
+                        _best_solution,
+                        _best_afisa_sol,
+                        _penalty_coeff,
+                        _perturbation,
+                        (rd::uniform(0, 100) < 50 ? Perturbation::no_tabu
+                                                  : Perturbation::unlimited),
+                        _max_time);
 }
 
 void afisa_original_tabu(Solution &solution,
@@ -95,14 +87,13 @@ void afisa_original_tabu(Solution &solution,
     const int nb_max_colors{static_cast<int>(std::max(solution.nb_colors(), 15) * 1.15)};
     std::vector<std::vector<long>> tabu_matrix(Graph::g->nb_vertices,
                                                std::vector<long>(nb_max_colors, 0));
-    std::uniform_int_distribution<int> distribution(0, 10);
     // tabu search loop
+    Deadline deadline(max_time);
     long turn_tabu{0};
-    while (not Parameters::p->time_limit_reached_sub_method(max_time) and
+    while (not deadline.reached() and
            turn_tabu < turns) {
         turn_tabu++;
-        std::vector<Coloration> best_coloration;
-        int best_evaluation{std::numeric_limits<int>::max()};
+        BestMoveSelector<Coloration> best_coloration(Coloration{-1, -1});
 
         auto possible_colors{solution.non_empty_colors()};
         if (static_cast<int>(possible_colors.size()) < nb_max_colors) {
@@ -122,25 +113,23 @@ void afisa_original_tabu(Solution &solution,
                     solution.score_wvcp() + solution.delta_wvcp_score(vertex, color) +
                     penalty_coeff * (delta_penalty + solution.penalty())};
                 // save best moves
-                if ((test_score < best_evaluation and
+                if ((test_score < best_coloration.best_key() and
                      tabu_matrix[vertex][color] <= turn_tabu) or
                     (test_score < best_solution.score_wvcp() and
                      (solution.penalty() + delta_penalty == 0))) {
-                    best_coloration.clear();
-                    best_coloration.emplace_back(Coloration{vertex, color});
-                    best_evaluation = test_score;
-                } else if (test_score == best_evaluation and
+                    best_coloration.restart(Coloration{vertex, color}, test_score);
+                } else if (test_score == best_coloration.best_key() and
                            (tabu_matrix[vertex][color] <= turn_tabu or
                             (test_score < best_solution.score_wvcp() and
                              (solution.penalty() + delta_penalty == 0)))) {
-                    best_coloration.emplace_back(Coloration{vertex, color});
+                    best_coloration.add_tie(Coloration{vertex, color});
                 }
             }
         }
         // check if a best move if found (may be empty depending on the size of the tabu
         // list)
         if (not best_coloration.empty()) {
-            const Coloration chosen_one{rd::choice(best_coloration)};
+            const Coloration chosen_one{best_coloration.move()};
             const int old_color{solution.delete_from_color(chosen_one.vertex)};
             solution.add_to_color(chosen_one.vertex, chosen_one.color);
 
@@ -148,7 +137,7 @@ void afisa_original_tabu(Solution &solution,
             switch (perturbation) {
             case Perturbation::no_perturbation:
                 tabu_matrix[chosen_one.vertex][old_color] =
-                    static_cast<int>(turn_tabu) + distribution(rd::generator) +
+                    static_cast<int>(turn_tabu) + rd::uniform(0, 10) +
                     static_cast<int>(solution.score_wvcp() +
                                      penalty_coeff * solution.penalty() * 0.6);
                 break;
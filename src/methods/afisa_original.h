@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../representation/Solution.h"
+#include "LocalSearchWorkspace.h"
+#include "ResumableLocalSearch.h"
 
 /**
  * @brief afisa main algorithm
@@ -11,9 +13,48 @@
  * Information Sciences 466, 203–219. https://doi.org/10.1016/j.ins.2018.07.037
  *
  * @param solution solution to use, the solution will be modified but stay legal
+ * @param workspace buffers of the local search
  * @param verbose True if print csv line each time new best scores is found
  */
-void afisa_original(Solution &solution, const bool verbose = false);
+void afisa_original(Solution &solution,
+                    LocalSearchWorkspace &workspace,
+                    const bool verbose = false);
+
+/**
+ * @brief Resumable version of afisa_original (see ResumableLocalSearch)
+ *
+ */
+class AfisaOriginal : public ResumableLocalSearch {
+    /** @brief Best solution of afisa (can have conflicts)*/
+    Solution _best_afisa_sol;
+    /** @brief Coefficient of the penalty in the evaluation*/
+    int _penalty_coeff{1};
+    /** @brief Number of turns without improvement*/
+    int _no_improvement{0};
+    /** @brief Number of turns of the small perturbation*/
+    const long _small_perturbation;
+    /** @brief Number of turns of the large perturbation*/
+    const long _large_perturbation;
+    /** @brief Number of turns of the next perturbation*/
+    long _perturbation;
+    /** @brief Number of turns of the tabu phase*/
+    const long _nb_turn_tabu;
+
+    void one_turn() override;
+
+  public:
+    /**
+     * @brief Construct the search
+     *
+     * @param best_solution solution to use, the solution will be modified but stay
+     * legal
+     * @param workspace buffers of the local search (not used)
+     * @param verbose True if print csv line each time new best scores is found
+     */
+    AfisaOriginal(Solution &best_solution,
+                  LocalSearchWorkspace &workspace,
+                  const bool verbose);
+};
 
 /**
  * @brief Tabu search for afisa
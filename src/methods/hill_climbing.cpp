@@ -1,44 +1,46 @@
 #include "hill_climbing.h"
 
-#include "../utils/random_generator.h"
+#include "../utils/moves_scan.h"
 #include "../utils/utils.h"
 
-void hill_climbing_one_move(Solution &solution, const bool verbose) {
-    int64_t best_time{0};
-    long turn{0};
-    while (not Parameters::p->time_limit_reached() and
-           solution.score_wvcp() != Parameters::p->target) {
-        ++turn;
-        std::vector<Coloration> best_coloration;
-        int best_evaluation = solution.score_wvcp();
-        for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
-            for (const auto color : solution.non_empty_colors()) {
-                if (color == solution.color(vertex) or
-                    solution.conflicts_colors(color, vertex) != 0) {
-                    continue;
-                }
-                const int test_score{solution.score_wvcp() +
-                                     solution.delta_wvcp_score(vertex, color)};
-                if (test_score < best_evaluation) {
-                    best_coloration.clear();
-                    best_coloration.emplace_back(Coloration{vertex, color});
-                    best_evaluation = test_score;
-                } else if (test_score == best_evaluation and
-                           not best_coloration.empty()) {
-                    best_coloration.emplace_back(Coloration{vertex, color});
-                }
-            }
-        }
-        if (best_coloration.empty()) {
-            return;
-        }
-        const Coloration chosen_one{rd::choice(best_coloration)};
-        solution.delete_from_color(chosen_one.vertex);
-        solution.add_to_color(chosen_one.vertex, chosen_one.color);
-        if (verbose) {
-            best_time =
-                Parameters::p->elapsed_time(std::chrono::high_resolution_clock::now());
-            print_result_ls(best_time, solution, turn);
-        }
+void hill_climbing_one_move(Solution &solution,
+                            LocalSearchWorkspace &workspace,
+                            const bool verbose) {
+    HillClimbing(solution, workspace, verbose).run();
+}
+
+HillClimbing::HillClimbing(Solution &solution,
+                           LocalSearchWorkspace &workspace,
+                           const bool verbose)
+    : ResumableLocalSearch(solution, verbose), _workspace(workspace) {
+}
+
+[[nodiscard]] bool HillClimbing::can_continue() const {
+    return not Parameters::p->time_limit_reached() and
+           _best_solution.score_wvcp() != Parameters::p->target;
+}
+
+void HillClimbing::one_turn() {
+    // moves to colors without conflicts that improve the score the most
+    MovesScan &moves_scan{_workspace.moves_scan(1, 0, 0, 0)};
+    for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
+        moves_scan.set_vertex(
+            vertex, _best_solution.delta_wvcp_score_old_color(vertex), 0);
     }
-}
\ No newline at end of file
+    const Coloration chosen_one{moves_scan.random_best_move(_best_solution)};
+    if (chosen_one.vertex == -1) {
+        _finished = true;
+        return;
+    }
+    _best_solution.delete_from_color(chosen_one.vertex);
+    _best_solution.add_to_color(chosen_one.vertex, chosen_one.color);
+    if (_verbose) {
+        _best_time =
+            Parameters::p->elapsed_time(std::chrono::high_resolution_clock::now());
+        print_result_ls(_best_time, _best_solution, _turn);
+    }
+}
+
+void HillClimbing::end() {
+    // the last improvement is already printed
+}
@@ -1,11 +1,42 @@
 #pragma once
 
 #include "../representation/Solution.h"
+#include "LocalSearchWorkspace.h"
+#include "ResumableLocalSearch.h"
 
 /**
  * @brief Hill climbing with a one move operator, will stop when reach a best local score
  *
  * @param solution solution to use, the solution will be modified
+ * @param workspace buffers of the local search
  * @param verbose True if print csv line each time new best scores is found
  */
-void hill_climbing_one_move(Solution &solution, const bool verbose = false);
+void hill_climbing_one_move(Solution &solution,
+                            LocalSearchWorkspace &workspace,
+                            const bool verbose = false);
+
+/**
+ * @brief Resumable version of hill_climbing_one_move (see ResumableLocalSearch), the
+ * moves are applied directly to the solution
+ *
+ */
+class HillClimbing : public ResumableLocalSearch {
+    /** @brief Buffers of the local search*/
+    LocalSearchWorkspace &_workspace;
+
+    [[nodiscard]] bool can_continue() const override;
+
+    void one_turn() override;
+
+    void end() override;
+
+  public:
+    /**
+     * @brief Construct the search
+     *
+     * @param solution solution to use, the solution will be modified
+     * @param workspace buffers of the local search
+     * @param verbose True if print csv line each time the score improves
+     */
+    HillClimbing(Solution &solution, LocalSearchWorkspace &workspace, const bool verbose);
+};
@@ -6,92 +6,82 @@
 #include "../utils/random_generator.h"
 #include "../utils/utils.h"
 
-void ilsts(Solution &best_solution, const bool verbose) {
-
-    auto max_time{std::chrono::high_resolution_clock::now() +
-                  std::chrono::seconds(Parameters::p->max_time_local_search)};
-
-    int64_t best_time{0};
-
-    ProxiSolutionILSTS working_solution(best_solution);
-    std::vector<long> tabu(Graph::g->nb_vertices, 0);
+void ilsts(Solution &best_solution,
+           LocalSearchWorkspace &workspace,
+           const bool verbose) {
+    ILSTS(best_solution, workspace, verbose).run();
+}
 
-    long no_improve{0}; // number of iterations without improvement
-    long turn{0};
-    int force{1}; // perturbation strength
-    // vertices to shuffle to explore randomly
-    std::vector<int> vertices;
+ILSTS::ILSTS(Solution &best_solution, LocalSearchWorkspace &workspace, const bool verbose)
+    : ResumableLocalSearch(best_solution, verbose),
+      _workspace(workspace),
+      _working_solution(workspace.ilsts_solution(best_solution)),
+      _tabu(workspace.tabu()) {
     int n{Graph::g->nb_vertices};
-    std::generate(vertices.begin(), vertices.end(), [&n] {
+    std::generate(_vertices.begin(), _vertices.end(), [&n] {
         return --n;
     });
+}
 
-    while (turn < Parameters::p->nb_iter_local_search and
-           not Parameters::p->time_limit_reached_sub_method(max_time) and
-           best_solution.score_wvcp() != Parameters::p->target) {
-        ++turn;
-        ProxiSolutionILSTS next_s(working_solution);
+void ILSTS::one_turn() {
+    ProxiSolutionILSTS &next_s{_workspace.ilsts_next_solution(_working_solution)};
 
-        next_s.unassigned_random_heavy_vertices(force);
+    next_s.unassigned_random_heavy_vertices(_force);
 
-        long iter = 0;
-        while (next_s.has_unassigned_vertices() and iter < Graph::g->nb_vertices * 10 and
-               not Parameters::p->time_limit_reached_sub_method(max_time)) {
-            ++iter;
+    long iter = 0;
+    while (next_s.has_unassigned_vertices() and iter < Graph::g->nb_vertices * 10 and
+           not _deadline.reached()) {
+        ++iter;
 
-            if (next_s.has_unassigned_vertices() and M_1_2_3(next_s, iter, tabu)) {
-                assert(next_s.check_solution());
-                continue;
-            }
+        if (next_s.has_unassigned_vertices() and M_1_2_3(next_s, iter, _tabu)) {
+            assert(next_s.check_solution());
+            continue;
+        }
 
-            std::shuffle(vertices.begin(), vertices.end(), rd::generator);
-            if (next_s.has_unassigned_vertices() and M_4(next_s, iter, vertices, tabu)) {
-                assert(next_s.check_solution());
-                continue;
-            }
+        std::shuffle(_vertices.begin(), _vertices.end(), rd::generator);
+        if (next_s.has_unassigned_vertices() and M_4(next_s, iter, _vertices, _tabu)) {
+            assert(next_s.check_solution());
+            continue;
+        }
 
-            if (next_s.has_unassigned_vertices() and M_5(next_s, iter, vertices, tabu)) {
-                assert(next_s.check_solution());
-                continue;
-            }
+        if (next_s.has_unassigned_vertices() and M_5(next_s, iter, _vertices, _tabu)) {
+            assert(next_s.check_solution());
+            continue;
+        }
 
-            if (next_s.has_unassigned_vertices() and M_6(next_s, iter, tabu)) {
-                assert(next_s.check_solution());
-                continue;
-            }
-            break;
+        if (next_s.has_unassigned_vertices() and M_6(next_s, iter, _tabu)) {
+            assert(next_s.check_solution());
+            continue;
         }
-        if (next_s.get_score() < working_solution.get_score()) {
-            no_improve = 1;
-            working_solution = next_s;
-            force = 1;
-        } else if (no_improve <= Graph::g->nb_vertices) {
-            ++no_improve;
-            if (force == 3) {
-                force = 1;
-            } else {
-                ++force;
-            }
+        break;
+    }
+    if (next_s.get_score() < _working_solution.get_score()) {
+        _no_improve = 1;
+        _working_solution = next_s;
+        _force = 1;
+    } else if (_no_improve <= Graph::g->nb_vertices) {
+        ++_no_improve;
+        if (_force == 3) {
+            _force = 1;
         } else {
-            working_solution.perturb_vertices(1);
-            no_improve = 1;
+            ++_force;
         }
+    } else {
+        _working_solution.perturb_vertices(1);
+        _no_improve = 1;
+    }
 
-        if ((not working_solution.has_unassigned_vertices()) and
-            (best_solution.score_wvcp() > working_solution.score_wvcp())) {
-            best_solution = working_solution.solution();
-            if (verbose) {
-                best_time = Parameters::p->elapsed_time(
-                    std::chrono::high_resolution_clock::now());
-                print_result_ls(best_time, best_solution, turn);
-            }
-        } else if ((not working_solution.has_unassigned_vertices()) and
-                   (best_solution.score_wvcp() == working_solution.score_wvcp())) {
-            best_solution = working_solution.solution();
+    if ((not _working_solution.has_unassigned_vertices()) and
+        (_best_solution.score_wvcp() > _working_solution.score_wvcp())) {
+        _best_solution = _working_solution.solution();
+        if (_verbose) {
+            _best_time = Parameters::p->elapsed_time(
+                std::chrono::high_resolution_clock::now());
+            print_result_ls(_best_time, _best_solution, _turn);
         }
-    }
-    if (verbose) {
-        print_result_ls(best_time, best_solution, turn);
+    } else if ((not _working_solution.has_unassigned_vertices()) and
+               (_best_solution.score_wvcp() == _working_solution.score_wvcp())) {
+        _best_solution = _working_solution.solution();
     }
 }
 
@@ -115,7 +105,7 @@ bool M_1_2_3(ProxiSolutionILSTS &solution, const long iter, std::vector<long> &t
 
         std::vector<int> costs(solution.nb_colors(), 0);
         std::vector<int> relocated(solution.nb_colors(), 0);
-        for (const auto &neighbor : Graph::g->neighborhood[vertex]) {
+        for (const auto &neighbor : Graph::g->neighbors(vertex)) {
             int neighbor_color = solution.color(neighbor);
             if (neighbor_color == -1) {
                 continue;
@@ -136,12 +126,10 @@ bool M_1_2_3(ProxiSolutionILSTS &solution, const long iter, std::vector<long> &t
                     solution.conflicts_colors(neighbor_color, vertex) and
                 costs[neighbor_color] == 0) {
                 std::vector<int> unassigned;
-                for (int y : Graph::g->neighborhood[vertex]) {
-                    if (solution.color(y) == neighbor_color) {
-                        assert(solution.nb_free_colors(y) > 0);
-                        solution.delete_from_color(y);
-                        unassigned.push_back(y);
-                    }
+                solution.neighbors_in_color(vertex, neighbor_color, unassigned);
+                for (const int y : unassigned) {
+                    assert(solution.nb_free_colors(y) > 0);
+                    solution.delete_from_color(y);
                 }
                 if (solution.is_color_empty(neighbor_color)) {
                     neighbor_color = -1;
@@ -175,16 +163,16 @@ bool M_3(ProxiSolutionILSTS &solution,
     if (min_cost != 1) {
         return false;
     }
+    std::vector<int> neighbors;
+    solution.neighbors_in_color(vertex, min_color, neighbors);
     std::vector<int> unassigned;
-    for (const auto &y : Graph::g->neighborhood[vertex]) {
-        if (solution.color(y) == min_color) {
-            if (solution.nb_free_colors(y) > 0) {
-                unassigned.push_back(y);
-            } else {
-                solution.add_unassigned_vertex(y);
-            }
-            solution.delete_from_color(y);
+    for (const int y : neighbors) {
+        if (solution.nb_free_colors(y) > 0) {
+            unassigned.push_back(y);
+        } else {
+            solution.add_unassigned_vertex(y);
         }
+        solution.delete_from_color(y);
     }
 
     solution.add_to_color(vertex, solution.is_color_empty(min_color) ? -1 : min_color);
@@ -224,12 +212,12 @@ bool M_5(ProxiSolutionILSTS &solution,
 
     for (const auto &vertex : vertices) {
         if (not(solution.nb_free_colors(vertex) == 0 and tabu[vertex] < iter and
-                not Graph::g->neighborhood[vertex].empty() and
+                not Graph::g->neighbors(vertex).empty() and
                 solution.color(vertex) != -1)) {
             continue;
         }
         std::vector<int> relocated(solution.nb_colors(), 0);
-        for (const auto &neighbor : Graph::g->neighborhood[vertex]) {
+        for (const auto &neighbor : Graph::g->neighbors(vertex)) {
             int c_neighbor = solution.color(neighbor);
             if (c_neighbor == -1)
                 continue;
@@ -241,10 +229,11 @@ bool M_5(ProxiSolutionILSTS &solution,
                 }
             }
             if (relocated[c_neighbor] == solution.conflicts_colors(c_neighbor, vertex)) {
+                std::vector<int> neighbors;
+                solution.neighbors_in_color(vertex, c_neighbor, neighbors);
                 std::vector<int> unassigned;
-                for (const auto &y : Graph::g->neighborhood[vertex]) {
-                    if (solution.color(y) == c_neighbor and
-                        solution.nb_free_colors(y) > 0) {
+                for (const int y : neighbors) {
+                    if (solution.nb_free_colors(y) > 0) {
                         solution.delete_from_color(y);
                         unassigned.push_back(y);
                     }
@@ -272,7 +261,7 @@ bool M_6(ProxiSolutionILSTS &solution, const long iter, std::vector<long> &tabu)
     std::vector<int> relocated(solution.nb_colors(), 0);
     std::vector<int> costs(solution.nb_colors(), 0);
 
-    for (const auto &neighbor : Graph::g->neighborhood[v]) {
+    for (const auto &neighbor : Graph::g->neighbors(v)) {
         const int c_neighbor = solution.color(neighbor);
         if (c_neighbor == -1)
             continue;
@@ -295,17 +284,17 @@ bool M_6(ProxiSolutionILSTS &solution, const long iter, std::vector<long> &tabu)
     if (min_cost_c == -1) {
         return false;
     }
+    std::vector<int> neighbors;
+    solution.neighbors_in_color(v, min_cost_c, neighbors);
     std::vector<int> unassigned;
     std::fill(tabu.begin(), tabu.end(), 0);
-    for (const auto &y : Graph::g->neighborhood[v]) {
-        if (solution.color(y) == min_cost_c) {
-            if (solution.nb_free_colors(y) > 0) {
-                unassigned.push_back(y);
-            } else {
-                solution.add_unassigned_vertex(y);
-            }
-            solution.delete_from_color(y);
+    for (const int y : neighbors) {
+        if (solution.nb_free_colors(y) > 0) {
+            unassigned.push_back(y);
+        } else {
+            solution.add_unassigned_vertex(y);
         }
+        solution.delete_from_color(y);
     }
     tabu[v] = iter + static_cast<long>(solution.non_empty_colors().size());
     if (solution.is_color_empty(min_cost_c))
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../representation/ProxiSolutionILSTS.h"
+#include "LocalSearchWorkspace.h"
+#include "ResumableLocalSearch.h"
 
 /**
  * @brief Local search grenade from ILSTS
@@ -12,9 +14,44 @@
  * https://doi.org/10.1016/j.cor.2020.105087
  *
  * @param solution solution to use, the solution will be modified
+ * @param workspace buffers of the local search
  * @param verbose True if print csv line each time new best scores is found
  */
-void ilsts(Solution &solution, const bool verbose = false);
+void ilsts(Solution &solution,
+           LocalSearchWorkspace &workspace,
+           const bool verbose = false);
+
+/**
+ * @brief Resumable version of ilsts (see ResumableLocalSearch)
+ *
+ */
+class ILSTS : public ResumableLocalSearch {
+    /** @brief Buffers of the local search*/
+    LocalSearchWorkspace &_workspace;
+    /** @brief Current solution (in the workspace)*/
+    ProxiSolutionILSTS &_working_solution;
+    /** @brief For each vertex, iteration until which the vertex is tabu (in the
+     * workspace)*/
+    std::vector<long> &_tabu;
+    /** @brief Number of iterations without improvement*/
+    long _no_improve{0};
+    /** @brief Perturbation strength*/
+    int _force{1};
+    /** @brief Vertices to shuffle to explore randomly*/
+    std::vector<int> _vertices{};
+
+    void one_turn() override;
+
+  public:
+    /**
+     * @brief Construct the search
+     *
+     * @param best_solution solution to use, the solution will be modified
+     * @param workspace buffers of the local search
+     * @param verbose True if print csv line each time new best scores is found
+     */
+    ILSTS(Solution &best_solution, LocalSearchWorkspace &workspace, const bool verbose);
+};
 
 /**
  * @brief Step 1,2 and 3 of ILSTS algorithm
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../representation/ProxiSolutionRedLS.h"
+#include "LocalSearchWorkspace.h"
+#include "ResumableLocalSearch.h"
 
 /**
  * @brief Local search from redLS
@@ -12,9 +14,37 @@
  * https://doi.org/10.1609/aaai.v34i03.5624
  *
  * @param solution solution to use, the solution will be modified
+ * @param workspace buffers of the local search
  * @param verbose True if print csv line each time new best scores is found
  */
-void redls(Solution &solution, const bool verbose = false);
+void redls(Solution &solution,
+           LocalSearchWorkspace &workspace,
+           const bool verbose = false);
+
+/**
+ * @brief Resumable version of redls (see ResumableLocalSearch)
+ *
+ */
+class RedLS : public ResumableLocalSearch {
+    /** @brief Buffers of the local search*/
+    LocalSearchWorkspace &_workspace;
+    /** @brief Current solution (in the workspace)*/
+    ProxiSolutionRedLS &_solution;
+    /** @brief For each vertex, true if the vertex is tabu (in the workspace)*/
+    std::vector<bool> &_tabu_list;
+
+    void one_turn() override;
+
+  public:
+    /**
+     * @brief Construct the search
+     *
+     * @param best_solution solution to use, the solution will be modified
+     * @param workspace buffers of the local search
+     * @param verbose True if print csv line each time new best scores is found
+     */
+    RedLS(Solution &best_solution, LocalSearchWorkspace &workspace, const bool verbose);
+};
 
 /**
  * @brief Apply candidate moves set 1 (RedLS)
@@ -22,22 +52,28 @@ void redls(Solution &solution, const bool verbose = false);
  *
  * @param solution solution
  * @param best_local_score best score found in the local search
+ * @param tabu_list tabu list
+ * @param workspace buffers of the local search (for the scan of the moves)
  * @return bool true if a move have been applied
  */
 bool improve_conflicts_and_score(ProxiSolutionRedLS &solution,
                                  const int best_local_score,
-                                 std::vector<bool> &tabu_list);
+                                 std::vector<bool> &tabu_list,
+                                 LocalSearchWorkspace &workspace);
 
 /**
  * @brief Apply candidate moves set 2 (RedLS)
  *
  * @param solution solution to use, the solution will be modified
  * @param with_conf boolean flag indicating if the tabu list is activated
+ * @param tabu_list tabu list
+ * @param workspace buffers of the local search (for the scan of the moves)
  * @return bool true if a move have been applied
  */
 bool improve_conflicts(ProxiSolutionRedLS &solution,
                        const bool with_conf,
-                       std::vector<bool> &tabu_list);
+                       std::vector<bool> &tabu_list,
+                       LocalSearchWorkspace &workspace);
 
 /**
  * @brief Apply candidate moves set 3 (RedLS)
@@ -2,119 +2,108 @@
 
 #include <cassert>
 
+#include "../utils/moves_scan.h"
 #include "../utils/random_generator.h"
 #include "../utils/utils.h"
 
-void redls_freeze(Solution &best_solution, const bool verbose) {
-    auto max_time{std::chrono::high_resolution_clock::now() +
-                  std::chrono::seconds(Parameters::p->max_time_local_search)};
+void redls_freeze(Solution &best_solution,
+                  LocalSearchWorkspace &workspace,
+                  const bool verbose) {
+    RedLSFreeze(best_solution, workspace, verbose).run();
+}
 
-    int64_t best_time{0};
+RedLSFreeze::RedLSFreeze(Solution &best_solution,
+                         LocalSearchWorkspace &workspace,
+                         const bool verbose)
+    : ResumableLocalSearch(best_solution, verbose),
+      _workspace(workspace),
+      _solution(workspace.redls_solution(best_solution)),
+      _tabu_list(workspace.tabu_list()) {
+}
 
-    ProxiSolutionRedLS solution(best_solution);
-    std::vector<bool> tabu_list(Graph::g->nb_vertices, false);
-    long turn{0};
-    while (not Parameters::p->time_limit_reached_sub_method(max_time) and
-           turn < Parameters::p->nb_iter_local_search and
-           best_solution.score_wvcp() != Parameters::p->target) {
-        ++turn;
-        if (solution.penalty() == 0) {
-            while (improve_conflicts_freeze(solution, false, tabu_list)) {
-                assert(solution.check_solution());
-            }
+void RedLSFreeze::one_turn() {
+    if (_solution.penalty() == 0) {
+        while (improve_conflicts_freeze(_solution, false, _tabu_list, _workspace)) {
+            assert(_solution.check_solution());
+        }
 
-            if (solution.score_wvcp() < best_solution.score_wvcp()) {
-                best_solution = solution.solution();
-                if (verbose) {
-                    best_time = Parameters::p->elapsed_time(
-                        std::chrono::high_resolution_clock::now());
-                    print_result_ls(best_time, best_solution, turn);
-                }
-                if (solution.score_wvcp() == Parameters::p->target) {
-                    if (verbose) {
-                        print_result_ls(best_time, best_solution, turn);
-                    }
-                    return;
-                }
-            } else if (solution.score_wvcp() == best_solution.score_wvcp()) {
-                best_solution = solution.solution();
+        if (_solution.score_wvcp() < _best_solution.score_wvcp()) {
+            _best_solution = _solution.solution();
+            if (_verbose) {
+                _best_time = Parameters::p->elapsed_time(
+                    std::chrono::high_resolution_clock::now());
+                print_result_ls(_best_time, _best_solution, _turn);
             }
-            std::fill(tabu_list.begin(), tabu_list.end(), false);
-            if (not move_heaviest_vertices_freeze(solution)) {
-                // not colors available
+            if (_solution.score_wvcp() == Parameters::p->target) {
+                if (_verbose) {
+                    print_result_ls(_best_time, _best_solution, _turn);
+                }
+                _finished = true;
                 return;
             }
-            assert(solution.check_solution());
+        } else if (_solution.score_wvcp() == _best_solution.score_wvcp()) {
+            _best_solution = _solution.solution();
+        }
+        std::fill(_tabu_list.begin(), _tabu_list.end(), false);
+        if (not move_heaviest_vertices_freeze(_solution)) {
+            // not colors available
+            _finished = true;
+            return;
         }
+        assert(_solution.check_solution());
+    }
 
-        if (not improve_conflicts_and_score_freeze(
-                solution, best_solution.score_wvcp(), tabu_list)) {
+    if (not improve_conflicts_and_score_freeze(
+            _solution, _best_solution.score_wvcp(), _tabu_list, _workspace)) {
 
-            while (improve_conflicts_freeze(solution, true, tabu_list)) {
-                assert(solution.check_solution());
-            }
+        while (improve_conflicts_freeze(_solution, true, _tabu_list, _workspace)) {
+            assert(_solution.check_solution());
+        }
 
-            if (not solve_one_conflict_preserve_score_freeze(
-                    solution, best_solution.score_wvcp(), tabu_list)) {
-                // Increments edge weight
-                solution.increment_edge_weights();
-                if (not solution.conflict_edges().empty()) {
-                    if (not solve_one_conflict_freeze(
-                            solution, best_solution.score_wvcp(), tabu_list)) {
-                        return;
-                    }
+        if (not solve_one_conflict_preserve_score_freeze(
+                _solution, _best_solution.score_wvcp(), _tabu_list)) {
+            // Increments edge weight
+            _solution.increment_edge_weights();
+            if (not _solution.conflict_edges().empty()) {
+                if (not solve_one_conflict_freeze(
+                        _solution, _best_solution.score_wvcp(), _tabu_list)) {
+                    _finished = true;
+                    return;
                 }
             }
-            assert(solution.check_solution());
         }
-    }
-    if (verbose) {
-        print_result_ls(best_time, best_solution, turn);
+        assert(_solution.check_solution());
     }
 }
 
 bool improve_conflicts_and_score_freeze(ProxiSolutionRedLS &solution,
                                         const int best_local_score,
-                                        std::vector<bool> &tabu_list) {
-    std::vector<Coloration> best_colorations;
+                                        std::vector<bool> &tabu_list,
+                                        LocalSearchWorkspace &workspace) {
     const int delta_wvcp{std::abs(best_local_score - solution.score_wvcp())};
-    int best_conflicts{0};
-    for (int vertex{solution.first_free_vertex()}; vertex < Graph::g->nb_vertices;
-         ++vertex) {
-        // for each vertices in conflict
-        if (tabu_list[vertex] or not solution.has_conflicts(vertex)) {
+    // for each non tabu vertex in conflict, the moves that reduce the most the number of
+    // conflicts while improving the score
+    MovesScan &moves_scan{workspace.moves_scan(0, 1, delta_wvcp, -1)};
+    for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
+        if (vertex < solution.first_free_vertex() or tabu_list[vertex] or
+            not solution.has_conflicts(vertex)) {
+            moves_scan.exclude_vertex(vertex);
             continue;
         }
-        for (const auto &color : solution.non_empty_colors()) {
-            // for each color different from the color of the vertex
-            if (color == solution.color(vertex)) {
-                continue;
-            }
-            const int delta_conflicts = solution.delta_conflicts(vertex, color);
-            if (delta_conflicts >= 0 or delta_conflicts > best_conflicts or
-                solution.delta_wvcp_score(vertex, color) >= delta_wvcp) {
-                continue;
-            }
-            // pick the move that reduce the most the number of conflicts while
-            // improving the score
-            if (delta_conflicts < best_conflicts) {
-                best_conflicts = delta_conflicts;
-                best_colorations.clear();
-            }
-            best_colorations.emplace_back(Coloration{vertex, color});
-        }
+        moves_scan.set_vertex(vertex,
+                              solution.delta_wvcp_score_old_color(vertex),
+                              solution.conflicts_colors(solution.color(vertex), vertex));
     }
-
-    if (best_colorations.empty()) {
+    const Coloration best_move{moves_scan.random_best_move(solution)};
+    if (best_move.vertex == -1) {
         return false;
     }
-    // pick one of the best improving move randomly and apply it
-    const auto best_move{rd::choice(best_colorations)};
+    // apply one of the best improving move
     solution.delete_from_color(best_move.vertex);
     solution.add_to_color(best_move.vertex, best_move.color);
     // the vertex become tabu while its neighbors get out of the tabu list
     tabu_list[best_move.vertex] = true;
-    for (const auto &neighbor : Graph::g->neighborhood[best_move.vertex]) {
+    for (const auto &neighbor : Graph::g->neighbors(best_move.vertex)) {
         tabu_list[neighbor] = false;
     }
 
@@ -123,31 +112,27 @@ bool improve_conflicts_and_score_freeze(ProxiSolutionRedLS &solution,
 
 bool improve_conflicts_freeze(ProxiSolutionRedLS &solution,
                               const bool with_conf,
-                              std::vector<bool> &tabu_list) {
+                              std::vector<bool> &tabu_list,
+                              LocalSearchWorkspace &workspace) {
     // find a move that improve the number of conflict and possibly the score
     // if with_conf is true then the vertex must not be in the tabu list
     // if with_conf is true then the chosen vertex will be tabu after the move
-    std::vector<Coloration> best_colorations;
-    for (int vertex{solution.first_free_vertex()}; vertex < Graph::g->nb_vertices;
-         ++vertex) {
-        if (with_conf and tabu_list[vertex]) {
+    MovesScan &moves_scan{workspace.moves_scan(0, 0, 0, 0)};
+    for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
+        if (vertex < solution.first_free_vertex() or
+            (with_conf and tabu_list[vertex])) {
+            moves_scan.exclude_vertex(vertex);
             continue;
         }
-        for (const auto &color : solution.non_empty_colors()) {
-            if (color == solution.color(vertex) or
-                solution.delta_conflicts(vertex, color) > 0 or
-                solution.delta_wvcp_score(vertex, color) >= 0) {
-                continue;
-            }
-            best_colorations.emplace_back(Coloration{vertex, color});
-        }
+        moves_scan.set_vertex(vertex,
+                              solution.delta_wvcp_score_old_color(vertex),
+                              solution.conflicts_colors(solution.color(vertex), vertex));
     }
-
-    if (best_colorations.empty()) {
+    const Coloration chosen_one{moves_scan.random_best_move(solution)};
+    if (chosen_one.vertex == -1) {
         return false;
     }
 
-    const auto chosen_one{rd::choice(best_colorations)};
     solution.delete_from_color(chosen_one.vertex);
     solution.add_to_color(chosen_one.vertex, chosen_one.color);
 
@@ -3,111 +3,84 @@
 #include <algorithm>
 #include <assert.h>
 
+#include "../representation/ProxiSolutionTabuCol.h"
 #include "../utils/random_generator.h"
 #include "../utils/utils.h"
 
-void tabu_col(Solution &best_solution, const bool verbose) {
+void tabu_col(Solution &best_solution,
+              LocalSearchWorkspace &workspace,
+              const bool verbose) {
+    TabuCol(best_solution, workspace, verbose).run();
+}
 
-    const auto max_time{std::chrono::high_resolution_clock::now() +
-                        std::chrono::seconds(Parameters::p->max_time_local_search)};
+TabuCol::TabuCol(Solution &best_solution,
+                 LocalSearchWorkspace &workspace,
+                 const bool verbose)
+    : ResumableLocalSearch(best_solution, verbose),
+      _solution(workspace.tabu_col_solution(best_solution)) {
+    atomic_min(Solution::best_nb_colors,
+               static_cast<int>(best_solution.nb_non_empty_colors()));
+}
 
-    int64_t best_time{0};
+[[nodiscard]] bool TabuCol::can_continue() const {
+    return not _deadline.reached() and _turn < Parameters::p->nb_iter_local_search;
+}
 
-    if (best_solution.nb_non_empty_colors() < Solution::best_nb_colors) {
-        Solution::best_nb_colors = static_cast<int>(best_solution.nb_non_empty_colors());
+void TabuCol::one_turn() {
+    if (_solution.solution().nb_conflicting_vertices() == 0) {
+        _solution.remove_one_color_and_create_conflicts();
     }
-    std::uniform_int_distribution<int> distribution_tabu(0, 10);
-    std::uniform_int_distribution<int> distribution_vertices(0,
-                                                             Graph::g->nb_vertices - 1);
-    Solution solution(best_solution);
-    int turn_main{0};
-    while (not Parameters::p->time_limit_reached_sub_method(max_time) and
-           turn_main < Parameters::p->nb_iter_local_search) {
-
-        ++turn_main;
-        if (solution.nb_conflicting_vertices() == 0) {
-            solution.remove_one_color_and_create_conflicts();
-        }
-        int best_found{solution.penalty()};
-
-        std::vector<std::vector<int>> tabu_matrix(
-            Graph::g->nb_vertices, std::vector<int>(solution.nb_colors(), 0));
-        long turn{0};
-        while (not Parameters::p->time_limit_reached_sub_method(max_time) and
-               best_found != 0) {
+    int best_found{_solution.penalty()};
+    _solution.clear_tabu();
 
-            ++turn;
+    long turn{0};
+    while (not _deadline.reached() and best_found != 0) {
 
-            int best_current{std::numeric_limits<int>::max()};
-            std::vector<Coloration> best_colorations;
+        ++turn;
 
-            for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
-                // for each vertices in conflict
-                if (not solution.has_conflicts(vertex)) {
-                    continue;
-                }
-                for (const auto &color : solution.non_empty_colors()) {
-                    if (color == solution.color(vertex)) {
-                        continue;
-                    }
-                    const int delta_conflict{solution.delta_conflicts(vertex, color)};
-                    if (delta_conflict > best_current) {
-                        continue;
-                    }
-                    const bool is_move_tabu = tabu_matrix[vertex][color] >= turn;
-                    const bool is_improving =
-                        solution.penalty() + delta_conflict < best_found;
-                    if (is_move_tabu and not is_improving) {
-                        continue;
-                    }
-                    if (delta_conflict < best_current) {
-                        best_current = delta_conflict;
-                        best_colorations.clear();
-                    }
-                    best_colorations.emplace_back(Coloration{vertex, color});
-                }
+        Coloration coloration{_solution.best_move(turn, best_found)};
+        if (coloration.vertex == -1) {
+            // all the moves are tabu, random move
+            const auto &non_empty_colors{_solution.solution().non_empty_colors()};
+            if (non_empty_colors.size() < 2) {
+                // no move can remove the conflicts of a single color, the next turns
+                // would not make progress either
+                _finished = true;
+                return;
             }
-            if (best_colorations.empty()) {
-                const int vertex = distribution_vertices(rd::generator);
-                // const int vertex = rd::choice(conflicting_vertices);
-                int color = rd::choice(solution.non_empty_colors());
-                while (color != solution.color(vertex))
-                    color = rd::choice(solution.non_empty_colors());
-                best_colorations.emplace_back(Coloration{vertex, color});
+            coloration.vertex = rd::uniform(0, Graph::g->nb_vertices - 1);
+            coloration.color = rd::choice(non_empty_colors);
+            while (coloration.color == _solution.solution().color(coloration.vertex)) {
+                coloration.color = rd::choice(non_empty_colors);
             }
+        }
 
-            const auto [vertex, color]{rd::choice(best_colorations)};
-            const int old_color{solution.delete_from_color(vertex)};
-            solution.add_to_color(vertex, color);
+        const auto [vertex, color]{coloration};
+        const int old_color{_solution.move(vertex, color)};
 
-            tabu_matrix[vertex][old_color] = static_cast<int>(turn) +
-                                             distribution_tabu(rd::generator) +
-                                             static_cast<int>(solution.penalty() * 0.6);
+        _solution.set_tabu(vertex,
+                           old_color,
+                           turn + rd::uniform(0, 10) +
+                               static_cast<int>(_solution.penalty() * 0.6));
 
-            if (solution.penalty() < best_found) {
-                best_found = solution.penalty();
-                // if (verbose) {
-                //     print_result_ls(Parameters::p->elapsed_time(
-                //                         std::chrono::high_resolution_clock::now()),
-                //                     solution,
-                //                     0);
-                // }
-            }
-        }
-        if (solution.penalty() == 0) {
-            best_solution = solution;
-            if (solution.nb_non_empty_colors() < Solution::best_nb_colors) {
-                Solution::best_nb_colors =
-                    static_cast<int>(solution.nb_non_empty_colors());
-            }
-            if (verbose) {
-                best_time = Parameters::p->elapsed_time(
-                    std::chrono::high_resolution_clock::now());
-                print_result_ls(best_time, solution, turn);
-            }
+        if (_solution.penalty() < best_found) {
+            best_found = _solution.penalty();
+            // if (verbose) {
+            //     print_result_ls(Parameters::p->elapsed_time(
+            //                         std::chrono::high_resolution_clock::now()),
+            //                     solution,
+            //                     0);
+            // }
         }
     }
-    if (verbose) {
-        print_result_ls(best_time, best_solution, turn_main);
+    if (_solution.penalty() == 0) {
+        _best_solution = _solution.solution();
+        atomic_min(Solution::best_nb_colors,
+                   static_cast<int>(_best_solution.nb_non_empty_colors()));
+        if (_verbose) {
+            _best_time = Parameters::p->elapsed_time(
+                std::chrono::high_resolution_clock::now());
+            print_result_ls(_best_time, _best_solution, turn);
+        }
     }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../representation/Solution.h"
+#include "LocalSearchWorkspace.h"
+#include "ResumableLocalSearch.h"
 
 /**
  * @brief TabuCol
@@ -21,6 +23,32 @@
  * the number of colors again and reduce the number of conflict again and again...
  *
  * @param solution solution to use, the solution will be modified
+ * @param workspace buffers of the local search
  * @param verbose True if print csv line each time new best scores is found
  */
-void tabu_col(Solution &solution, const bool verbose = false);
+void tabu_col(Solution &solution,
+              LocalSearchWorkspace &workspace,
+              const bool verbose = false);
+
+/**
+ * @brief Resumable version of tabu_col (see ResumableLocalSearch)
+ *
+ */
+class TabuCol : public ResumableLocalSearch {
+    /** @brief Current solution (in the workspace)*/
+    ProxiSolutionTabuCol &_solution;
+
+    [[nodiscard]] bool can_continue() const override;
+
+    void one_turn() override;
+
+  public:
+    /**
+     * @brief Construct the search
+     *
+     * @param best_solution solution to use, the solution will be modified
+     * @param workspace buffers of the local search
+     * @param verbose True if print csv line each time new best scores is found
+     */
+    TabuCol(Solution &best_solution, LocalSearchWorkspace &workspace, const bool verbose);
+};
@@ -1,12 +1,40 @@
 #pragma once
 
 #include "../representation/Solution.h"
+#include "LocalSearchWorkspace.h"
+#include "ResumableLocalSearch.h"
 
 /**
  * @brief Tabu search with a one move operator inspired from TabuCol but considering
  * weights of the graph
  *
  * @param solution solution to use, the solution will be modified
+ * @param workspace buffers of the local search
  * @param verbose True if print csv line each time new best scores is found
  */
-void tabu_weight(Solution &solution, const bool verbose = false);
+void tabu_weight(Solution &solution,
+                 LocalSearchWorkspace &workspace,
+                 const bool verbose = false);
+
+/**
+ * @brief Resumable version of tabu_weight (see ResumableLocalSearch)
+ *
+ */
+class TabuWeight : public ResumableLocalSearch {
+    /** @brief Current solution (in the workspace)*/
+    ProxiSolutionTabuWeight &_solution;
+
+    void one_turn() override;
+
+  public:
+    /**
+     * @brief Construct the search
+     *
+     * @param best_solution solution to use, the solution will be modified
+     * @param workspace buffers of the local search
+     * @param verbose True if print csv line each time new best scores is found
+     */
+    TabuWeight(Solution &best_solution,
+               LocalSearchWorkspace &workspace,
+               const bool verbose);
+};
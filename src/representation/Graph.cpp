@@ -1,6 +1,14 @@
 #include "Graph.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
+#include <functional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Weffc++"
@@ -9,12 +17,287 @@
 
 std::unique_ptr<const Graph> Graph::g = nullptr;
 
-void Graph::init_graph(const std::string &instance_name, const std::string problem) {
-    // load the edges and vertices of the graph
-    std::ifstream file;
-    file.open("../instances/" + problem + "_reduced/" + instance_name + ".col");
+namespace {
 
-    if (!file) {
+/**
+ * @brief Read only memory mapping of a whole file, unmapped at destruction
+ *
+ */
+class MappedFile {
+    /** @brief First byte of the file (nullptr if empty or not opened)*/
+    const char *_data{nullptr};
+    /** @brief Size of the file in bytes*/
+    size_t _size{0};
+    /** @brief True if the file has been opened*/
+    bool _opened{false};
+
+  public:
+    /**
+     * @brief Map the file in memory, is_open() is false if the file can't be read
+     *
+     * @param file_name file to map
+     */
+    explicit MappedFile(const std::string &file_name) {
+        const int fd{open(file_name.c_str(), O_RDONLY)};
+        if (fd < 0) {
+            return;
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0) {
+            _size = static_cast<size_t>(file_stat.st_size);
+            _opened = true;
+            if (_size > 0) {
+                void *data{mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0)};
+                if (data == MAP_FAILED) {
+                    _opened = false;
+                    _size = 0;
+                } else {
+                    madvise(data, _size, MADV_SEQUENTIAL);
+                    _data = static_cast<const char *>(data);
+                }
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (_data) {
+            munmap(const_cast<char *>(_data), _size);
+        }
+    }
+
+    MappedFile(const MappedFile &other) = delete;
+    MappedFile &operator=(const MappedFile &other) = delete;
+
+    [[nodiscard]] bool is_open() const {
+        return _opened;
+    }
+
+    [[nodiscard]] const char *begin() const {
+        return _data;
+    }
+
+    [[nodiscard]] const char *end() const {
+        return _data + _size;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _size;
+    }
+};
+
+/**
+ * @brief Return true if the character is a space, a tab or an end of line
+ */
+[[nodiscard]] bool is_space(const char c) {
+    return c == ' ' or c == '\t' or c == '\n' or c == '\r' or c == '\v' or c == '\f';
+}
+
+/**
+ * @brief Move the cursor after the next end of line
+ */
+void skip_line(const char *&cursor, const char *end) {
+    const void *eol{std::memchr(cursor, '\n', static_cast<size_t>(end - cursor))};
+    cursor = eol ? static_cast<const char *>(eol) + 1 : end;
+}
+
+/**
+ * @brief Skip the spaces then read a non negative integer like operator>>
+ *
+ * @param cursor position in the file, moved after the integer
+ * @param end end of the file
+ * @param value read value
+ * @return true an integer has been read
+ * @return false no integer before the next token or the end of the file
+ */
+bool read_int(const char *&cursor, const char *end, int &value) {
+    while (cursor != end and is_space(*cursor)) {
+        ++cursor;
+    }
+    if (cursor == end or *cursor < '0' or *cursor > '9') {
+        return false;
+    }
+    value = 0;
+    while (cursor != end and *cursor >= '0' and *cursor <= '9') {
+        value = value * 10 + (*cursor - '0');
+        ++cursor;
+    }
+    return true;
+}
+
+/**
+ * @brief Print an error message and stop the program if an edge is not valid
+ */
+void check_edge(const std::string &file_name,
+                const int nb_vertices,
+                const int vertex1,
+                const int vertex2) {
+    if (vertex1 < 0 or vertex1 >= nb_vertices or vertex2 < 0 or
+        vertex2 >= nb_vertices) {
+        fmt::print(stderr,
+                   "Error in {} : edge {} {} out of the {} vertices of the graph\n",
+                   file_name,
+                   vertex1 + 1,
+                   vertex2 + 1,
+                   nb_vertices);
+        exit(1);
+    }
+}
+
+/** @brief Identification of the binary cache files of the graphs*/
+constexpr char cache_magic[8] = {'G', 'C', 'W', 'V', 'C', 'P', 'G', '\0'};
+
+/** @brief Version of the binary cache files, to increase when the format changes*/
+constexpr uint32_t cache_version{1};
+
+/**
+ * @brief Header of a binary cache file, followed by the neighbors offsets
+ * (nb_vertices + 1 ints), the neighbors targets (nb_targets ints) and the weights
+ * (nb_vertices ints)
+ *
+ */
+struct CacheHeader {
+    /** @brief Always cache_magic*/
+    char magic[8];
+    /** @brief Always cache_version*/
+    uint32_t version;
+    /** @brief Number of vertices in the graph*/
+    int32_t nb_vertices;
+    /** @brief Number of edges in the graph (Graph::nb_edges)*/
+    int32_t nb_edges;
+    /** @brief Size of the CSR neighbors targets*/
+    int32_t nb_targets;
+    /** @brief Size in bytes of the .col file the cache has been created from*/
+    int64_t col_size;
+    /** @brief Last modification time of the .col file*/
+    int64_t col_mtime;
+    /** @brief Size in bytes of the .col.w file (-1 without weights)*/
+    int64_t weights_size;
+    /** @brief Last modification time of the .col.w file (-1 without weights)*/
+    int64_t weights_mtime;
+};
+
+/**
+ * @brief Set the size and modification time of the file in the header of the cache
+ *
+ * @return false if the file can't be found
+ */
+bool stat_source(const std::string &file_name, int64_t &size, int64_t &mtime) {
+    struct stat file_stat;
+    if (stat(file_name.c_str(), &file_stat) != 0) {
+        return false;
+    }
+    size = file_stat.st_size;
+    mtime = file_stat.st_mtime;
+    return true;
+}
+
+/**
+ * @brief Load the graph from the binary cache if it exists and matches the header
+ *
+ * @return true the graph has been loaded
+ * @return false the cache is missing, outdated or corrupted
+ */
+bool load_cache(const std::string &cache_file,
+                const CacheHeader &expected,
+                int &nb_vertices,
+                int &nb_edges,
+                std::vector<int> &neighbors_offsets,
+                std::vector<int> &neighbors_targets,
+                std::vector<int> &weights) {
+    const MappedFile file(cache_file);
+    if (not file.is_open() or file.size() < sizeof(CacheHeader)) {
+        return false;
+    }
+    CacheHeader header;
+    std::memcpy(&header, file.begin(), sizeof(CacheHeader));
+    if (std::memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0 or
+        header.version != cache_version or header.col_size != expected.col_size or
+        header.col_mtime != expected.col_mtime or
+        header.weights_size != expected.weights_size or
+        header.weights_mtime != expected.weights_mtime or header.nb_vertices < 0 or
+        header.nb_targets < 0) {
+        return false;
+    }
+    const size_t nb_offsets{static_cast<size_t>(header.nb_vertices) + 1};
+    const size_t nb_targets{static_cast<size_t>(header.nb_targets)};
+    const size_t nb_weights{static_cast<size_t>(header.nb_vertices)};
+    if (file.size() !=
+        sizeof(CacheHeader) + (nb_offsets + nb_targets + nb_weights) * sizeof(int)) {
+        return false;
+    }
+    const char *cursor{file.begin() + sizeof(CacheHeader)};
+    neighbors_offsets.resize(nb_offsets);
+    std::memcpy(neighbors_offsets.data(), cursor, nb_offsets * sizeof(int));
+    cursor += nb_offsets * sizeof(int);
+    neighbors_targets.resize(nb_targets);
+    std::memcpy(neighbors_targets.data(), cursor, nb_targets * sizeof(int));
+    cursor += nb_targets * sizeof(int);
+    weights.resize(nb_weights);
+    std::memcpy(weights.data(), cursor, nb_weights * sizeof(int));
+    // a corrupted cache with a valid header is rebuilt instead of giving invalid spans
+    bool valid{neighbors_offsets.front() == 0 and
+               neighbors_offsets.back() == header.nb_targets};
+    for (size_t vertex{0}; valid and vertex + 1 < nb_offsets; ++vertex) {
+        valid = neighbors_offsets[vertex] <= neighbors_offsets[vertex + 1];
+    }
+    for (size_t i{0}; valid and i < nb_targets; ++i) {
+        valid = neighbors_targets[i] >= 0 and neighbors_targets[i] < header.nb_vertices;
+    }
+    if (not valid) {
+        // the graph is then read from the .col file into the same vectors
+        neighbors_offsets.clear();
+        neighbors_targets.clear();
+        weights.clear();
+        return false;
+    }
+    nb_vertices = header.nb_vertices;
+    nb_edges = header.nb_edges;
+    return true;
+}
+
+/**
+ * @brief Write the graph in the binary cache, in a temporary file renamed at the end
+ * so concurrent runs never read a partial cache
+ *
+ */
+void save_cache(const std::string &cache_file,
+                const CacheHeader &header,
+                const std::vector<int> &neighbors_offsets,
+                const std::vector<int> &neighbors_targets,
+                const std::vector<int> &weights) {
+    const std::string tmp_file{cache_file + ".tmp" + std::to_string(getpid())};
+    std::ofstream file(tmp_file, std::ios::binary);
+    if (file) {
+        file.write(reinterpret_cast<const char *>(&header), sizeof(CacheHeader));
+        for (const auto *values : {&neighbors_offsets, &neighbors_targets, &weights}) {
+            file.write(reinterpret_cast<const char *>(values->data()),
+                       static_cast<std::streamsize>(values->size() * sizeof(int)));
+        }
+        file.close();
+    }
+    if (not file or std::rename(tmp_file.c_str(), cache_file.c_str()) != 0) {
+        std::remove(tmp_file.c_str());
+        fmt::print(stderr, "Warning : unable to write the graph cache {}\n", cache_file);
+    }
+}
+
+} // namespace
+
+void Graph::init_graph(const std::string &instance_name,
+                       const std::string problem,
+                       const std::string &cache_directory) {
+    const std::string col_file{"../instances/" + problem + "_reduced/" + instance_name +
+                               ".col"};
+    const std::string weights_file{"../instances/wvcp_reduced/" + instance_name +
+                                   ".col.w"};
+    CacheHeader header;
+    std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    header.version = cache_version;
+    header.weights_size = -1;
+    header.weights_mtime = -1;
+
+    if (not stat_source(col_file, header.col_size, header.col_mtime)) {
         fmt::print(stderr,
                    "Didn't find {} in ../instances/{}_reduced/ or "
                    "../instances/gcp_reduced/ (if problem == gcp)\n"
@@ -28,60 +311,187 @@ void Graph::init_graph(const std::string &instance_name, const std::string probl
                    problem);
         exit(1);
     }
-    int nb_vertices{0}, nb_edges{0}, n1{0}, n2{0};
-    std::vector<std::pair<int, int>> edges_list;
-    std::string first;
-    file >> first;
-    while (!file.eof()) {
-        if (first == "e") {
-            file >> n1 >> n2;
-            edges_list.emplace_back(--n1, --n2);
-        } else if (first == "p") {
-            file >> first >> nb_vertices >> nb_edges;
-            edges_list.reserve(nb_edges);
-        } else {
-            getline(file, first);
-        }
-        file >> first;
+    if (problem == "wvcp" and
+        not stat_source(weights_file, header.weights_size, header.weights_mtime)) {
+        fmt::print(stderr,
+                   "Didn't find weights for {} in ../instances/wvcp_reduced/\n",
+                   instance_name);
+        exit(1);
     }
-    file.close();
-
-    std::vector<int> weights(nb_vertices, 1);
 
-    if (problem == "wvcp") {
-        // load the weights of the vertices
-        std::ifstream w_file("../instances/wvcp_reduced/" + instance_name + ".col.w");
-        if (!w_file) {
-            fmt::print(stderr,
-                       "Didn't find weights for {} in ../instances/wvcp_reduced/\n",
-                       instance_name);
+    int nb_vertices{0}, nb_edges{0};
+    std::vector<int> neighbors_offsets;
+    std::vector<int> neighbors_targets;
+    std::vector<int> weights;
+    const std::string cache_file{cache_directory + "/" + problem + "_" + instance_name +
+                                 ".graph"};
+    const bool from_cache{not cache_directory.empty() and load_cache(cache_file,
+                                                                      header,
+                                                                      nb_vertices,
+                                                                      nb_edges,
+                                                                      neighbors_offsets,
+                                                                      neighbors_targets,
+                                                                      weights)};
+    std::vector<std::pair<int, int>> edges;
+    if (not from_cache) {
+        // load the edges and vertices of the graph, the file is mapped in memory and
+        // read line by line (c : comment, p : problem line, e : edge)
+        const MappedFile file(col_file);
+        if (not file.is_open()) {
+            fmt::print(stderr, "Unable to read {}\n", col_file);
             exit(1);
         }
-        size_t i(0);
-        while (!w_file.eof()) {
-            w_file >> weights[i];
-            ++i;
+        const char *cursor{file.begin()};
+        const char *end{file.end()};
+        while (cursor != end) {
+            while (cursor != end and is_space(*cursor)) {
+                ++cursor;
+            }
+            if (end - cursor > 1 and is_space(cursor[1])) {
+                if (cursor[0] == 'e') {
+                    int n1{0}, n2{0};
+                    ++cursor;
+                    if (read_int(cursor, end, n1) and read_int(cursor, end, n2)) {
+                        check_edge(col_file, nb_vertices, n1 - 1, n2 - 1);
+                        edges.emplace_back(n1 - 1, n2 - 1);
+                    }
+                } else if (cursor[0] == 'p') {
+                    // p edge nb_vertices nb_edges
+                    ++cursor;
+                    while (cursor != end and is_space(*cursor)) {
+                        ++cursor;
+                    }
+                    while (cursor != end and not is_space(*cursor)) {
+                        ++cursor;
+                    }
+                    read_int(cursor, end, nb_vertices);
+                    read_int(cursor, end, nb_edges);
+                    edges.reserve(static_cast<size_t>(nb_edges));
+                }
+            }
+            skip_line(cursor, end);
+        }
+
+        weights.assign(static_cast<size_t>(nb_vertices), 1);
+        if (problem == "wvcp") {
+            // load the weights of the vertices
+            const MappedFile w_file(weights_file);
+            if (not w_file.is_open()) {
+                fmt::print(stderr, "Unable to read {}\n", weights_file);
+                exit(1);
+            }
+            const char *w_cursor{w_file.begin()};
+            for (int &weight : weights) {
+                if (not read_int(w_cursor, w_file.end(), weight)) {
+                    break;
+                }
+            }
         }
-        w_file.close();
     }
 
-    std::vector<std::vector<bool>> adjacency_matrix(
-        nb_vertices, std::vector<bool>(nb_vertices, false));
-    std::vector<std::vector<int>> neighborhood(nb_vertices, std::vector<int>(0));
+    const int nb_words{nb_words_per_row(nb_vertices)};
+    const size_t row_size{static_cast<size_t>(nb_words)};
+    Bitset adjacency_matrix(static_cast<size_t>(nb_vertices) * row_size, 0);
+    if (from_cache) {
+        // Init adjacency matrix from the neighborhood
+        for (int vertex{0}; vertex < nb_vertices; ++vertex) {
+            uint64_t *row{adjacency_matrix.data() +
+                          static_cast<size_t>(vertex) * row_size};
+            const int first{neighbors_offsets[vertex]};
+            const int last{neighbors_offsets[vertex + 1]};
+            for (int i{first}; i < last; ++i) {
+                const int neighbor{neighbors_targets[i]};
+                if (neighbor < 0 or neighbor >= nb_vertices) {
+                    fmt::print(stderr, "Corrupted graph cache {}\n", cache_file);
+                    exit(1);
+                }
+                row[neighbor >> 6] |= uint64_t{1} << (neighbor & 63);
+            }
+        }
+    } else {
+        // Init adjacency matrix
+        for (const auto &[vertex1, vertex2] : edges) {
+            uint64_t *row1{adjacency_matrix.data() +
+                           static_cast<size_t>(vertex1) * row_size};
+            uint64_t *row2{adjacency_matrix.data() +
+                           static_cast<size_t>(vertex2) * row_size};
+            row1[vertex2 >> 6] |= uint64_t{1} << (vertex2 & 63);
+            row2[vertex1 >> 6] |= uint64_t{1} << (vertex1 & 63);
+        }
+        // Init neighborhood (CSR) from the rows of the adjacency matrix, so duplicated
+        // edges are ignored and the neighbors are sorted
+        neighbors_offsets.assign(static_cast<size_t>(nb_vertices) + 1, 0);
+        neighbors_targets.reserve(edges.size() * 2);
+        for (int vertex{0}; vertex < nb_vertices; ++vertex) {
+            const uint64_t *row{adjacency_matrix.data() +
+                                static_cast<size_t>(vertex) * row_size};
+            for (int word{0}; word < nb_words; ++word) {
+                uint64_t bits{row[word]};
+                while (bits) {
+                    neighbors_targets.push_back(word * 64 + __builtin_ctzll(bits));
+                    bits &= bits - 1;
+                }
+            }
+            neighbors_offsets[vertex + 1] = static_cast<int>(neighbors_targets.size());
+        }
+        nb_edges += static_cast<int>(neighbors_targets.size() / 2);
+
+        if (not cache_directory.empty()) {
+            header.nb_vertices = nb_vertices;
+            header.nb_edges = nb_edges;
+            header.nb_targets = static_cast<int32_t>(neighbors_targets.size());
+            save_cache(cache_file, header, neighbors_offsets, neighbors_targets, weights);
+        }
+    }
+
+    // Init degrees and list of the edges (without duplicates) from the neighborhood
     std::vector<int> degrees(nb_vertices, 0);
-    // Init adjacency matrix and neighborhood of the vertices
-    for (auto p : edges_list) {
-        if (not adjacency_matrix[p.first][p.second]) {
-            adjacency_matrix[p.first][p.second] = true;
-            adjacency_matrix[p.second][p.first] = true;
-            neighborhood[p.first].push_back(p.second);
-            neighborhood[p.second].push_back(p.first);
-            ++nb_edges;
+    std::vector<std::pair<int, int>> edges_list;
+    edges_list.reserve(neighbors_targets.size() / 2);
+    for (int vertex{0}; vertex < nb_vertices; ++vertex) {
+        degrees[vertex] = neighbors_offsets[vertex + 1] - neighbors_offsets[vertex];
+        for (int i{neighbors_offsets[vertex]}; i < neighbors_offsets[vertex + 1]; ++i) {
+            if (neighbors_targets[i] > vertex) {
+                edges_list.emplace_back(vertex, neighbors_targets[i]);
+            }
         }
     }
-    // Init degrees_ of the vertices
+    // Init the reverse edges, the neighbors of a vertex being sorted, its edges are
+    // reached by increasing neighbor
+    std::vector<int> reverse_neighbors(neighbors_targets.size());
+    std::vector<int> next_reverse(neighbors_offsets.begin(), neighbors_offsets.end() - 1);
     for (int vertex{0}; vertex < nb_vertices; ++vertex) {
-        degrees[vertex] = static_cast<int>(neighborhood[vertex].size());
+        for (int i{neighbors_offsets[vertex]}; i < neighbors_offsets[vertex + 1]; ++i) {
+            reverse_neighbors[i] = next_reverse[neighbors_targets[i]]++;
+        }
+    }
+    // Init the levels of weight of the vertices
+    std::vector<int> distinct_weights(weights);
+    std::sort(distinct_weights.begin(), distinct_weights.end(), std::greater<int>());
+    distinct_weights.erase(std::unique(distinct_weights.begin(), distinct_weights.end()),
+                           distinct_weights.end());
+    std::vector<int> weight_levels(nb_vertices, 0);
+    for (int vertex{0}; vertex < nb_vertices; ++vertex) {
+        weight_levels[vertex] = static_cast<int>(
+            std::lower_bound(distinct_weights.begin(),
+                             distinct_weights.end(),
+                             weights[vertex],
+                             std::greater<int>()) -
+            distinct_weights.begin());
+    }
+    // Sort the vertices by level of weight (counting sort, the vertices of a level stay
+    // sorted by number)
+    std::vector<int> levels_offsets(distinct_weights.size() + 1, 0);
+    for (int vertex{0}; vertex < nb_vertices; ++vertex) {
+        ++levels_offsets[weight_levels[vertex] + 1];
+    }
+    for (size_t level{0}; level < distinct_weights.size(); ++level) {
+        levels_offsets[level + 1] += levels_offsets[level];
+    }
+    std::vector<int> levels_vertices(nb_vertices);
+    std::vector<int> next_position(levels_offsets.begin(), levels_offsets.end() - 1);
+    for (int vertex{0}; vertex < nb_vertices; ++vertex) {
+        levels_vertices[next_position[weight_levels[vertex]]++] = vertex;
     }
     // Uncomment to check if the vertices are well sorted
     // for(int vertex(0); vertex < nb_vertices-1; ++vertex){
@@ -99,25 +509,98 @@ void Graph::init_graph(const std::string &instance_name, const std::string probl
                                        nb_edges,
                                        edges_list,
                                        adjacency_matrix,
-                                       neighborhood,
+                                       neighbors_offsets,
+                                       neighbors_targets,
+                                       reverse_neighbors,
                                        degrees,
-                                       weights);
+                                       weights,
+                                       distinct_weights,
+                                       weight_levels,
+                                       levels_vertices,
+                                       levels_offsets);
 }
 
 Graph::Graph(const std::string &name_,
              const int &nb_vertices_,
              const int &nb_edges_,
              const std::vector<std::pair<int, int>> &edges_list_,
-             const std::vector<std::vector<bool>> &adjacency_matrix_,
-             const std::vector<std::vector<int>> &neighborhood_,
+             const Bitset &adjacency_matrix_,
+             const std::vector<int> &neighbors_offsets_,
+             const std::vector<int> &neighbors_targets_,
+             const std::vector<int> &reverse_neighbors_,
              const std::vector<int> &degrees_,
-             const std::vector<int> &weights_)
+             const std::vector<int> &weights_,
+             const std::vector<int> &distinct_weights_,
+             const std::vector<int> &weight_levels_,
+             const std::vector<int> &levels_vertices_,
+             const std::vector<int> &levels_offsets_)
     : name(name_),
       nb_vertices(nb_vertices_),
       nb_edges(nb_edges_),
       edges_list(edges_list_),
+      nb_words(nb_words_per_row(nb_vertices_)),
       adjacency_matrix(adjacency_matrix_),
-      neighborhood(neighborhood_),
+      neighbors_offsets(neighbors_offsets_),
+      neighbors_targets(neighbors_targets_),
+      reverse_neighbors(reverse_neighbors_),
       degrees(degrees_),
-      weights(weights_) {
+      weights(weights_),
+      distinct_weights(distinct_weights_),
+      weight_levels(weight_levels_),
+      levels_vertices(levels_vertices_),
+      levels_offsets(levels_offsets_) {
+}
+
+[[nodiscard]] Span<const int> Graph::vertices_between_weights(const int lower,
+                                                             const int upper) const {
+    // the levels are sorted by decreasing weight, the first level is the first one with
+    // a weight lower or equal to upper and the levels stop at the first one with a
+    // weight lower or equal to lower
+    const auto first_level{std::lower_bound(distinct_weights.begin(),
+                                            distinct_weights.end(),
+                                            upper,
+                                            std::greater<int>()) -
+                           distinct_weights.begin()};
+    const auto end_level{std::lower_bound(distinct_weights.begin(),
+                                          distinct_weights.end(),
+                                          lower,
+                                          std::greater<int>()) -
+                         distinct_weights.begin()};
+    const int *vertices{levels_vertices.data()};
+    if (end_level <= first_level) {
+        return {vertices, vertices};
+    }
+    return {vertices + levels_offsets[first_level], vertices + levels_offsets[end_level]};
+}
+
+[[nodiscard]] int Graph::nb_words_per_row(const int nb_vertices) {
+    // 64 bits per word, 8 words per cache line
+    return ((nb_vertices + 511) / 512) * 8;
+}
+
+void Graph::add_to_bitset(uint64_t *bitset, const int vertex) {
+    bitset[vertex >> 6] |= uint64_t{1} << (vertex & 63);
+}
+
+void Graph::remove_from_bitset(uint64_t *bitset, const int vertex) {
+    bitset[vertex >> 6] &= ~(uint64_t{1} << (vertex & 63));
+}
+
+[[nodiscard]] const uint64_t *Graph::adjacency_row(const int vertex) const {
+    return adjacency_matrix.data() +
+           static_cast<size_t>(vertex) * static_cast<size_t>(nb_words);
+}
+
+void Graph::neighbors_in(const int vertex,
+                         const uint64_t *vertices,
+                         std::vector<int> &neighbors) const {
+    neighbors.clear();
+    const uint64_t *row{adjacency_row(vertex)};
+    for (int word{0}; word < nb_words; ++word) {
+        uint64_t bits{row[word] & vertices[word]};
+        while (bits) {
+            neighbors.push_back(word * 64 + __builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
 }
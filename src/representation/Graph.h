@@ -1,9 +1,16 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "../utils/aligned_allocator.h"
+#include "../utils/span.h"
+
+/** @brief Bitset of vertices, stored in 64 bits words aligned on a cache line*/
+typedef std::vector<uint64_t, AlignedAllocator<uint64_t>> Bitset;
+
 /**
  * @brief Struct Graph use information from .col and .col.w files to create an instance of
  * a graph
@@ -26,11 +33,27 @@ struct Graph {
     /** @brief List of the edges in the graph*/
     const std::vector<std::pair<int, int>> edges_list;
 
-    /** @brief Adjacency matrix, true if there is an edge between vertex i and vertex j*/
-    const std::vector<std::vector<bool>> adjacency_matrix;
+    /** @brief Number of 64 bits words in a row of the adjacency matrix (padded to a
+     * multiple of a cache line)*/
+    const int nb_words;
+
+    /** @brief Adjacency matrix as one flat bitset, row i starts at word i * nb_words and
+     * its bit j is set if there is an edge between vertex i and vertex j*/
+    const Bitset adjacency_matrix;
+
+    /** @brief Neighborhood in CSR format, the neighbors of vertex v are stored in
+     * neighbors_targets from index neighbors_offsets[v] to neighbors_offsets[v + 1]
+     * (nb_vertices + 1 values)*/
+    const std::vector<int> neighbors_offsets;
+
+    /** @brief Neighbors of all the vertices in one contiguous buffer, for each vertex
+     * they are sorted by vertex number (so by decreasing weight then degree)*/
+    const std::vector<int> neighbors_targets;
 
-    /** @brief For each vertex, the list of its neighbors*/
-    const std::vector<std::vector<int>> neighborhood;
+    /** @brief For each index i of neighbors_targets (edge from v to
+     * neighbors_targets[i]), index of the reverse edge in neighbors_targets (edge from
+     * neighbors_targets[i] to v)*/
+    const std::vector<int> reverse_neighbors;
 
     /** @brief For each vertex, its degree*/
     const std::vector<int> degrees;
@@ -38,13 +61,33 @@ struct Graph {
     /** @brief For each vertex, its weight*/
     const std::vector<int> weights;
 
+    /** @brief Distinct weights of the vertices by decreasing order*/
+    const std::vector<int> distinct_weights;
+
+    /** @brief For each vertex, the index of its weight in distinct_weights (0 for the
+     * heaviest vertices)*/
+    const std::vector<int> weight_levels;
+
+    /** @brief Vertices sorted by level of weight, the vertices of the level l are stored
+     * from index levels_offsets[l] to levels_offsets[l + 1]*/
+    const std::vector<int> levels_vertices;
+
+    /** @brief For each level of weight, index of its first vertex in levels_vertices
+     * (nb levels + 1 values)*/
+    const std::vector<int> levels_offsets;
+
     /**
      * @brief Init the graph for the search with the reduced version of it
      *
      * @param instance_name graph to load
      * @param problem type of problem (gcp,wvcp)
+     * @param cache_directory directory of the binary cache of the graphs (one .graph
+     * file per instance, rebuilt when the .col or .col.w file changes), empty to always
+     * parse the .col files
      */
-    static void init_graph(const std::string &instance_name, const std::string problem);
+    static void init_graph(const std::string &instance_name,
+                           const std::string problem,
+                           const std::string &cache_directory = "");
 
     /**
      * @brief Construct a new Graph
@@ -53,20 +96,35 @@ struct Graph {
      * @param nb_vertices_ Number of vertices in the graph
      * @param nb_edges_ Number of edges in the graph
      * @param edges_list_ List of the edges in the graph
-     * @param adjacency_matrix_ Adjacency matrix, true if there is an edge between vertex
-     * i and vertex j
-     * @param neighborhood_ For each vertex, the list of its neighbors
+     * @param adjacency_matrix_ Adjacency matrix as a flat bitset of nb_vertices rows of
+     * nb_words_per_row(nb_vertices) words
+     * @param neighbors_offsets_ For each vertex, index of its first neighbor in
+     * neighbors_targets_ (plus the total number of neighbors at the end)
+     * @param neighbors_targets_ Neighbors of all the vertices
+     * @param reverse_neighbors_ For each index of neighbors_targets_, index of the
+     * reverse edge
      * @param degrees_ For each vertex, its degree
      * @param weights_ For each vertex, its weight
+     * @param distinct_weights_ Distinct weights by decreasing order
+     * @param weight_levels_ For each vertex, the index of its weight in distinct_weights_
+     * @param levels_vertices_ Vertices sorted by level of weight
+     * @param levels_offsets_ For each level, index of its first vertex in
+     * levels_vertices_
      */
     explicit Graph(const std::string &name_,
                    const int &nb_vertices_,
                    const int &nb_edges_,
                    const std::vector<std::pair<int, int>> &edges_list_,
-                   const std::vector<std::vector<bool>> &adjacency_matrix_,
-                   const std::vector<std::vector<int>> &neighborhood_,
+                   const Bitset &adjacency_matrix_,
+                   const std::vector<int> &neighbors_offsets_,
+                   const std::vector<int> &neighbors_targets_,
+                   const std::vector<int> &reverse_neighbors_,
                    const std::vector<int> &degrees_,
-                   const std::vector<int> &weights_);
+                   const std::vector<int> &weights_,
+                   const std::vector<int> &distinct_weights_,
+                   const std::vector<int> &weight_levels_,
+                   const std::vector<int> &levels_vertices_,
+                   const std::vector<int> &levels_offsets_);
 
     /**
      * @brief Construct a copy of a Graph object deleted
@@ -74,4 +132,75 @@ struct Graph {
      * @param other the graph to not copy
      */
     Graph(const Graph &other) = delete;
+
+    /**
+     * @brief Return the neighbors of the vertex
+     *
+     * @param vertex the vertex
+     * @return Span<const int> the neighbors (view on neighbors_targets)
+     */
+    [[nodiscard]] Span<const int> neighbors(const int vertex) const {
+        // defined in the header to be inlined in the loops on the neighbors
+        const int *targets{neighbors_targets.data()};
+        return {targets + neighbors_offsets[vertex],
+                targets + neighbors_offsets[vertex + 1]};
+    }
+
+    /**
+     * @brief Return the vertices whose weight is higher than lower and lower or equal to
+     * upper
+     *
+     * @param lower the weights of the vertices are higher
+     * @param upper the weights of the vertices are lower or equal
+     * @return Span<const int> the vertices (view on levels_vertices)
+     */
+    [[nodiscard]] Span<const int> vertices_between_weights(const int lower,
+                                                           const int upper) const;
+
+    /**
+     * @brief Number of 64 bits words used to store one bit per vertex, padded to a
+     * multiple of a cache line (8 words) so each row of a bitset matrix is aligned
+     *
+     * @param nb_vertices number of vertices
+     * @return int number of words
+     */
+    [[nodiscard]] static int nb_words_per_row(const int nb_vertices);
+
+    /**
+     * @brief Add the vertex to the bitset
+     *
+     * @param bitset first word of the bitset
+     * @param vertex the vertex to add
+     */
+    static void add_to_bitset(uint64_t *bitset, const int vertex);
+
+    /**
+     * @brief Remove the vertex from the bitset
+     *
+     * @param bitset first word of the bitset
+     * @param vertex the vertex to remove
+     */
+    static void remove_from_bitset(uint64_t *bitset, const int vertex);
+
+    /**
+     * @brief Return the row of the vertex in the adjacency matrix (nb_words words)
+     *
+     * @param vertex the vertex
+     * @return const uint64_t* first word of the row
+     */
+    [[nodiscard]] const uint64_t *adjacency_row(const int vertex) const;
+
+    /**
+     * @brief Give the neighbors of the vertex in the set of vertices by increasing
+     * number, as a walk on the neighbors would find them (AND word by word on the row of
+     * the vertex)
+     *
+     * @param vertex the vertex
+     * @param vertices first word of the set of vertices (nb_words words, for example a
+     * color class)
+     * @param neighbors the neighbors in the set, the vector is cleared first
+     */
+    void neighbors_in(const int vertex,
+                      const uint64_t *vertices,
+                      std::vector<int> &neighbors) const;
 };
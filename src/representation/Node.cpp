@@ -3,73 +3,322 @@
 #include <algorithm>
 #include <cmath>
 
+#include "../utils/random_generator.h"
+#include "../utils/utils.h"
 #include "Parameters.h"
 
-long Node::total_nodes = 0;
-long Node::nb_current_nodes = 0;
-int Node::height = 1;
-
-Node::Node(Node *parent_node,
-           const Action &move,
-           const std::vector<Action> &possible_moves)
-    : _parent_node{parent_node},
-      _move{move},
-      _possible_moves(possible_moves),
-      _visits(0) {
-    if (_parent_node) {
-        _depth = _parent_node->_depth + 1;
-    }
-    if (_depth > height) {
-        height = _depth;
-    }
-    _id = total_nodes;
-    ++total_nodes;
+std::vector<std::unique_ptr<Node[]>> Node::chunks;
+std::vector<int> Node::free_nodes;
+std::mutex Node::pool_mutex;
+std::atomic<long> Node::nb_allocated_nodes{0};
+std::atomic<long> Node::total_nodes{0};
+std::atomic<long> Node::nb_current_nodes{0};
+std::atomic<int> Node::height{1};
+std::atomic<long> Node::vectors_memory{0};
+
+[[nodiscard]] int Node::allocate() {
+    const std::lock_guard<std::mutex> lock(pool_mutex);
+    if (not free_nodes.empty()) {
+        const int index{free_nodes.back()};
+        free_nodes.pop_back();
+        return index;
+    }
+    if (chunks.empty()) {
+        // the table of chunks is never resized so the other threads can read it
+        chunks.resize(max_nb_chunks);
+    }
+    const long index{nb_allocated_nodes};
+    const long chunk{index / chunk_size};
+    if (chunk >= max_nb_chunks) {
+        fmt::print(stderr, "Too many nodes in the MCTS tree ({})\n", index);
+        exit(1);
+    }
+    if (index % chunk_size == 0) {
+        chunks[static_cast<size_t>(chunk)] = std::make_unique<Node[]>(chunk_size);
+    }
+    ++nb_allocated_nodes;
+    return static_cast<int>(index);
+}
+
+void Node::init(const int parent,
+                const int depth,
+                const Action &move,
+                const std::vector<Action> &possible_moves,
+                const int virtual_loss) {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    _parent = parent;
+    _move = move;
+    // the vectors of a reused slot keep their capacity
+    const size_t old_capacity{_possible_moves.capacity()};
+    _possible_moves.assign(possible_moves.begin(), possible_moves.end());
+    track_memory(old_capacity, _possible_moves);
+    _children.clear();
+    _nb_pending_moves = 0;
+    _visits = 0;
+    _virtual_loss = virtual_loss;
+    _score = 0;
+    _sort_score = 0;
+    _rank = 0;
+    _nb_ranked_children = 0;
+    _ranks_outdated = false;
+    _score_ucb = 0;
+    _depth = depth;
+    atomic_max(height, _depth);
+    _id = total_nodes++;
     ++nb_current_nodes;
 }
 
-Node::~Node() {
-    _parent_node = nullptr;
-    _children_nodes.clear();
-    nb_current_nodes--;
-}
-
-void Node::update(const double &score) {
-    _score = ((_score * _visits) + score) / (_visits + 1);
-    ++_visits;
-    if (not _children_nodes.empty()) {
-        // delete empty children
-        auto it{_children_nodes.begin()};
-        while (it != _children_nodes.end()) {
-            if (it->get()->_children_nodes.empty() and
-                it->get()->_possible_moves.empty()) {
-                it = _children_nodes.erase(it);
-            } else {
-                ++it;
-            }
+long Node::delete_branch(const int index) {
+    Node &node{get(index)};
+    long nb_deleted{1};
+    {
+        const std::lock_guard<std::mutex> lock(node._mutex);
+        ++node._generation;
+        for (const int child : node._children) {
+            nb_deleted += delete_branch(child);
         }
-        std::stable_sort(
-            _children_nodes.begin(),
-            _children_nodes.end(),
-            [](const std::shared_ptr<Node> &n1, const std::shared_ptr<Node> &n2) {
-                return n1->_score > n2->_score;
-            });
-        const double sum_rank =
-            static_cast<double>(_children_nodes.size() * (_children_nodes.size() + 1)) /
-            2;
-        int i{0};
-        for (auto &child : _children_nodes) {
-            child->_exploitation = ++i / sum_rank;
-            child->_exploration = std::sqrt(2 * std::log(_visits) / child->_visits);
-            child->_score_ucb = child->_exploitation +
-                                Parameters::p->coeff_exploi_explo * child->_exploration;
+        node._children.clear();
+        node._possible_moves.clear();
+        --nb_current_nodes;
+    }
+    const std::lock_guard<std::mutex> lock(pool_mutex);
+    free_nodes.push_back(index);
+    return nb_deleted;
+}
+
+[[nodiscard]] NodeLink Node::create_root(const Action &move,
+                                         const std::vector<Action> &possible_moves) {
+    const int index{allocate()};
+    Node &node{get(index)};
+    node.init(-1, 0, move, possible_moves, 0);
+    const std::lock_guard<std::mutex> lock(node._mutex);
+    return {index, node._generation};
+}
+
+[[nodiscard]] NodeLink Node::add_child(const NodeLink &parent,
+                                       const Action &move,
+                                       const std::vector<Action> &possible_moves) {
+    const int index{allocate()};
+    Node &parent_node{get(parent.index)};
+    const std::lock_guard<std::mutex> lock(parent_node._mutex);
+    if (not exists(parent)) {
+        const std::lock_guard<std::mutex> lock_pool(pool_mutex);
+        free_nodes.push_back(index);
+        return {};
+    }
+    Node &node{get(index)};
+    // the thread creating the node is in its branch until the update
+    node.init(parent.index, parent_node._depth + 1, move, possible_moves, 1);
+    const size_t old_capacity{parent_node._children.capacity()};
+    parent_node._children.push_back(index);
+    track_memory(old_capacity, parent_node._children);
+    --parent_node._nb_pending_moves;
+    return {index, node._generation};
+}
+
+void Node::delete_tree(const NodeLink &root) {
+    delete_branch(root.index);
+}
+
+long Node::shrink_tree(const NodeLink &root, const long max_nodes) {
+    struct Branch {
+        NodeLink parent;
+        NodeLink node;
+        int visits;
+    };
+    // list the branches of the tree
+    std::vector<Branch> branches;
+    std::vector<NodeLink> to_visit{root};
+    long nb_nodes{0};
+    while (not to_visit.empty()) {
+        const NodeLink link{to_visit.back()};
+        to_visit.pop_back();
+        const Node &node{get(link.index)};
+        const std::lock_guard<std::mutex> lock(node._mutex);
+        if (not exists(link)) {
+            continue;
+        }
+        ++nb_nodes;
+        for (const int child : node._children) {
+            const NodeLink child_link{child, get(child)._generation};
+            branches.push_back({link, child_link, get(child)._visits});
+            to_visit.push_back(child_link);
         }
     }
-    if (_parent_node) {
-        _parent_node->update(score);
+    if (nb_nodes <= max_nodes) {
+        return nb_nodes;
+    }
+    // collapse the least visited branches first, the deepest first between ties
+    std::reverse(branches.begin(), branches.end());
+    std::stable_sort(
+        branches.begin(), branches.end(), [](const Branch &b1, const Branch &b2) {
+            return b1.visits < b2.visits;
+        });
+    for (const auto &branch : branches) {
+        if (nb_nodes <= max_nodes) {
+            break;
+        }
+        Node &parent{get(branch.parent.index)};
+        const std::lock_guard<std::mutex> lock(parent._mutex);
+        if (not exists(branch.parent) or not exists(branch.node)) {
+            // the branch has already been deleted
+            continue;
+        }
+        const Action move{get(branch.node.index)._move};
+        parent._children.erase(std::find(
+            parent._children.begin(), parent._children.end(), branch.node.index));
+        nb_nodes -= delete_branch(branch.node.index);
+        parent._ranks_outdated = true;
+        // the possible moves stay sorted
+        std::vector<Action> &moves{parent._possible_moves};
+        const size_t old_capacity{moves.capacity()};
+        moves.insert(std::upper_bound(moves.begin(), moves.end(), move, compare_actions),
+                     move);
+        track_memory(old_capacity, moves);
     }
+    return nb_nodes;
+}
+
+[[nodiscard]] Node &Node::get(const int index) {
+    return chunks[static_cast<size_t>(index / chunk_size)][index % chunk_size];
+}
+
+[[nodiscard]] bool Node::exists(const NodeLink &link) {
+    return get(link.index)._generation == link.generation;
+}
+
+void Node::update(const NodeLink &link,
+                  const NodeLink &child,
+                  const double &score,
+                  const bool virtual_loss) {
+    Node &node{get(link.index)};
+    const std::lock_guard<std::mutex> lock(node._mutex);
+    if (not exists(link)) {
+        // the node has been deleted by another thread
+        return;
+    }
+    if (virtual_loss) {
+        --node._virtual_loss;
+    }
+    const int visits{node._visits};
+    node._score = ((node._score * visits) + score) / (visits + 1);
+    node._visits = visits + 1;
+    if (child.index != -1 and exists(child)) {
+        // only the child of the branch changed since the last update of the node
+        if (get(child.index).fully_explored()) {
+            node.delete_child(child.index);
+        } else {
+            node.move_child(child.index);
+        }
+    }
+    if (node._ranks_outdated) {
+        node._ranks_outdated = false;
+        int rank{0};
+        for (const int index : node._children) {
+            get(index)._rank = ++rank;
+        }
+    }
+    node._nb_ranked_children = static_cast<int>(node._children.size());
+}
+
+void Node::delete_child(const int index) {
+    _children.erase(std::find(_children.begin(), _children.end(), index));
+    delete_branch(index);
+    _ranks_outdated = true;
+}
+
+void Node::move_child(const int index) {
+    Node &child{get(index)};
+    auto position{static_cast<size_t>(child._rank - 1)};
+    if (child._rank == 0 or position >= _children.size() or
+        _children[position] != index) {
+        // new child or children deleted since the last rank update
+        position = static_cast<size_t>(
+            std::find(_children.begin(), _children.end(), index) - _children.begin());
+        _ranks_outdated = true;
+    }
+    // the children are sorted by decreasing score (the higher rank for the best child),
+    // the scores can be updated by other threads so the score used for the sort is kept
+    child._sort_score = child._score;
+    while (position > 0 and
+           get(_children[position - 1])._sort_score < child._sort_score) {
+        _children[position] = _children[position - 1];
+        ++get(_children[position])._rank;
+        --position;
+    }
+    while (position + 1 < _children.size() and
+           get(_children[position + 1])._sort_score > child._sort_score) {
+        _children[position] = _children[position + 1];
+        --get(_children[position])._rank;
+        ++position;
+    }
+    _children[position] = index;
+    child._rank = static_cast<int>(position) + 1;
+}
+
+void Node::remove_virtual_loss(const NodeLink &link) {
+    Node &node{get(link.index)};
+    const std::lock_guard<std::mutex> lock(node._mutex);
+    if (exists(link)) {
+        --node._virtual_loss;
+    }
+}
+
+void Node::end_expansion(const NodeLink &link) {
+    Node &node{get(link.index)};
+    const std::lock_guard<std::mutex> lock(node._mutex);
+    if (exists(link)) {
+        --node._nb_pending_moves;
+    }
+}
+
+[[nodiscard]] std::mutex &Node::mutex() const {
+    return _mutex;
+}
+
+[[nodiscard]] NodeLink Node::best_child() {
+    // the UCB scores are computed with the ranks and the visits of the last update
+    const double sum_rank{static_cast<double>(_nb_ranked_children) *
+                          (_nb_ranked_children + 1) / 2};
+    const double log_visits{std::log(std::max(1, _visits.load()))};
+    double max_score{std::numeric_limits<double>::lowest()};
+    std::vector<int> next_nodes;
+    for (const int index : _children) {
+        Node &node{get(index)};
+        // a child can be expanded by another thread and not yet updated
+        const int child_visits{std::max(1, node._visits.load())};
+        const double exploitation{node._rank / sum_rank};
+        const double exploration{std::sqrt(2 * log_visits / child_visits)};
+        double score_ucb{exploitation + Parameters::p->coeff_exploi_explo * exploration};
+        const int virtual_loss{node._virtual_loss};
+        if (virtual_loss > 0) {
+            // the visits of the threads in the branch count as visits without gain
+            const int visits{node._visits};
+            const double ratio{static_cast<double>(visits) / (visits + virtual_loss)};
+            score_ucb = visits == 0 ? 0
+                                    : exploitation * ratio +
+                                          Parameters::p->coeff_exploi_explo *
+                                              exploration * std::sqrt(ratio);
+        }
+        node._score_ucb = score_ucb;
+        if (score_ucb > max_score) {
+            max_score = score_ucb;
+            next_nodes = {index};
+        } else if (score_ucb == max_score) {
+            next_nodes.push_back(index);
+        }
+    }
+    if (next_nodes.empty()) {
+        return {};
+    }
+    const int index{rd::choice(next_nodes)};
+    Node &next_node{get(index)};
+    ++next_node._virtual_loss;
+    return {index, next_node._generation};
 }
 
 bool Node::clean_graph(const int &score) {
+    const std::lock_guard<std::mutex> lock(_mutex);
     // delete possible children with possible too high score
     auto it_m{_possible_moves.begin()};
     while (it_m != _possible_moves.end()) {
@@ -80,21 +329,19 @@ bool Node::clean_graph(const int &score) {
         }
     }
     // delete children with a too high score
-    auto it{_children_nodes.begin()};
-    while (it != _children_nodes.end()) {
-        if (it->get()->_move.score >= score) {
-            it = _children_nodes.erase(it);
+    auto it{_children.begin()};
+    while (it != _children.end()) {
+        if (get(*it)._move.score >= score or not get(*it).clean_graph(score)) {
+            delete_branch(*it);
+            it = _children.erase(it);
+            _ranks_outdated = true;
         } else {
-            if (it->get()->clean_graph(score)) {
-                ++it;
-            } else {
-                it = _children_nodes.erase(it);
-            }
+            ++it;
         }
     }
 
     // if the node have no child and no possible child, then delete it
-    if (_children_nodes.empty() and _possible_moves.empty()) {
+    if (_children.empty() and _possible_moves.empty() and _nb_pending_moves == 0) {
         return false;
     }
     return true;
@@ -103,13 +350,10 @@ bool Node::clean_graph(const int &score) {
 [[nodiscard]] const Action Node::next_child() {
     const Action move{_possible_moves.back()};
     _possible_moves.pop_back();
+    ++_nb_pending_moves;
     return move;
 }
 
-void Node::add_child_to_parent(const std::shared_ptr<Node> &child) {
-    child->_parent_node->_children_nodes.push_back(child);
-}
-
 [[nodiscard]] const Action &Node::move() const {
     return _move;
 }
@@ -118,8 +362,8 @@ void Node::add_child_to_parent(const std::shared_ptr<Node> &child) {
     return _score_ucb;
 }
 
-[[nodiscard]] const std::vector<std::shared_ptr<Node>> &Node::children_nodes() {
-    return _children_nodes;
+[[nodiscard]] const std::vector<int> &Node::children_nodes() {
+    return _children;
 }
 
 [[nodiscard]] long Node::get_total_nodes() {
@@ -130,6 +374,14 @@ void Node::add_child_to_parent(const std::shared_ptr<Node> &child) {
     return nb_current_nodes - 1; // minus one for the current node in MCTS
 }
 
+[[nodiscard]] long Node::get_nb_allocated_nodes() {
+    return nb_allocated_nodes;
+}
+
+[[nodiscard]] long Node::get_memory() {
+    return nb_allocated_nodes * static_cast<long>(sizeof(Node)) + vectors_memory;
+}
+
 [[nodiscard]] int Node::get_height() {
     return height;
 }
@@ -143,19 +395,20 @@ void Node::add_child_to_parent(const std::shared_ptr<Node> &child) {
 }
 
 [[nodiscard]] bool Node::fully_explored() const {
-    return _possible_moves.empty() and _children_nodes.empty();
+    const std::lock_guard<std::mutex> lock(_mutex);
+    return _possible_moves.empty() and _children.empty() and _nb_pending_moves == 0;
 }
 
 std::string Node::format() const {
     return fmt::format("Action v {} c {} visits {} score {} UCB {}\n",
                        _move.vertex,
                        _move.color,
-                       _visits,
-                       _score,
+                       _visits.load(),
+                       _score.load(),
                        _score_ucb);
     // if (not this->terminal()) {
     //     std::string txt;
-    //     for (const auto &child : _children_nodes) {
+    //     for (const auto &child : _children) {
     //         txt += child->format();
     //     }
     //     return txt;
@@ -170,7 +423,7 @@ std::string Node::format() const {
     //                    _visits,
     //                    _score,
     //                    _score_ucb);
-    // for (const auto &child : _children_nodes) {
+    // for (const auto &child : _children) {
     //     txt += child->format();
     // }
     // return txt;
@@ -178,11 +431,11 @@ std::string Node::format() const {
 
 std::string Node::to_dot() const {
     std::string txt{};
-    if (not _parent_node) {
+    if (_parent == -1) {
         txt += "digraph G{\n";
     }
-    for (const auto &child : _children_nodes) {
-        txt += fmt::format("\n\tn{} -> n{} ;", _id, child->_id);
+    for (const int child : _children) {
+        txt += fmt::format("\n\tn{} -> n{} ;", _id, get(child)._id);
         // txt += fmt::format("\n\tn{} [label=\"n{}-s{:.0f}-v{}\"];",
         //                    child->id,
         //                    child->id,
@@ -190,10 +443,10 @@ std::string Node::to_dot() const {
         //                    child->_visits);
     }
 
-    for (const auto &child : _children_nodes) {
-        txt += child->to_dot();
+    for (const int child : _children) {
+        txt += get(child).to_dot();
     }
-    if (not _parent_node) {
+    if (_parent == -1) {
         txt += "\n}";
     }
     return txt;
@@ -1,58 +1,162 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "enum_types.h"
 
+/**
+ * @brief Link to a node of the pool of nodes, the generation of the node is kept to
+ * detect if the node has been deleted (and its slot reused) since the link was made
+ *
+ */
+struct NodeLink {
+    /** @brief Index of the node in the pool (-1 for no node)*/
+    int index{-1};
+    /** @brief Generation of the slot of the node when the link was made*/
+    unsigned generation{0};
+};
+
 /**
  * @brief Representation of a node for a MCTS
  *
+ * The nodes are stored in a pool of chunks of nodes that are never freed, the nodes are
+ * linked with their indexes in the pool and the nodes of the deleted branches are
+ * recycled with a free list.
+ *
+ * The tree can be shared by several threads : the mutex of a node protects its possible
+ * moves, its children and the UCB scores of its children. When two mutexes are locked,
+ * the parent is always locked before the child. As a slot can be reused elsewhere in the
+ * tree, a link is checked with exists before locking the children of its node.
+ *
  */
 class Node {
 
   private:
-    /** @brief Number of created nodes*/
-    static long total_nodes;
-    /** @brief Current number of nodes*/
-    static long nb_current_nodes;
-    /** @brief Height of the tree*/
-    static int height;
-
-    /** @brief Pointer to parent node*/
-    Node *_parent_node{};
+    /** @brief Number of nodes in a chunk of the pool*/
+    static constexpr int chunk_size{4096};
+    /** @brief Maximal number of chunks in the pool*/
+    static constexpr int max_nb_chunks{1 << 18};
+    /** @brief Chunks of nodes of the pool*/
+    static std::vector<std::unique_ptr<Node[]>> chunks;
+    /** @brief Indexes of the deleted nodes, ready to be reused*/
+    static std::vector<int> free_nodes;
+    /** @brief Protect the chunks and the free nodes*/
+    static std::mutex pool_mutex;
+    /** @brief Number of nodes allocated in the pool (used or free)*/
+    static std::atomic<long> nb_allocated_nodes;
+    /** @brief Number of created nodes (in the trees of all threads)*/
+    static std::atomic<long> total_nodes;
+    /** @brief Current number of nodes (in the trees of all threads)*/
+    static std::atomic<long> nb_current_nodes;
+    /** @brief Height of the tree (highest of the trees of all threads)*/
+    static std::atomic<int> height;
+    /** @brief Memory allocated by the vectors of the nodes of the pool (bytes)*/
+    static std::atomic<long> vectors_memory;
+
+    /** @brief Generation of the slot, incremented when the node is deleted*/
+    unsigned _generation{};
+    /** @brief Index of the parent node (-1 for the root)*/
+    int _parent{-1};
     /** @brief Move that lead from parent node to the current node*/
     Action _move{};
     /** @brief Possible next moves to children*/
     std::vector<Action> _possible_moves{};
-    /** @brief List of children*/
-    std::vector<std::shared_ptr<Node>> _children_nodes{};
+    /** @brief Indexes of the children*/
+    std::vector<int> _children{};
+    /** @brief Number of moves given by next_child whose expansion isn't finished*/
+    int _nb_pending_moves{};
+    /** @brief Protect the possible moves, the children and their UCB scores*/
+    mutable std::mutex _mutex{};
     /** @brief Number of visits on the node*/
-    int _visits{};
+    std::atomic<int> _visits{};
+    /** @brief Number of threads currently in the branch of the node (virtual loss)*/
+    std::atomic<int> _virtual_loss{};
     /** @brief Score of the node*/
-    double _score{};
-    /** @brief Score exploration*/
-    double _exploration{};
-    /** @brief Score exploitation*/
-    double _exploitation{};
-    /** @brief Score UCB*/
+    std::atomic<double> _score{};
+    /** @brief Score of the node when its parent sorted its children*/
+    double _sort_score{};
+    /** @brief Rank of the node among its siblings (the higher the better), position in
+     * the children of its parent plus one when the ranks are up to date*/
+    int _rank{};
+    /** @brief Number of children when the ranks of the children were updated*/
+    int _nb_ranked_children{};
+    /** @brief True if children have been deleted since the last update of the ranks*/
+    bool _ranks_outdated{};
+    /** @brief Score UCB at the last selection*/
     double _score_ucb{};
     /** @brief Depth of the node*/
     int _depth{};
     /** @brief ID of the node*/
     long _id{};
 
-  public:
     /**
-     * @brief Construct a new Node
+     * @brief Take a free slot in the pool of nodes, or add a new slot
      *
-     * @param parent_node parent node of the new node
-     * @param move Action that lead to the new node
+     * @return int index of the slot
+     */
+    [[nodiscard]] static int allocate();
+
+    /**
+     * @brief Initialize the slot with a new node
+     *
+     * @param parent index of the parent node (-1 for the root)
+     * @param depth depth of the node
+     * @param move Action that lead to the node
      * @param possible_moves possible actions that create new children to the node
+     * @param virtual_loss initial virtual loss of the node
+     */
+    void init(const int parent,
+              const int depth,
+              const Action &move,
+              const std::vector<Action> &possible_moves,
+              const int virtual_loss);
+
+    /**
+     * @brief Delete the node and its branch, the slots go back to the free list. The
+     * parent of the node must be locked (or the node must be the root).
+     *
+     * @param index index of the node
+     * @return long number of deleted nodes
+     */
+    static long delete_branch(const int index);
+
+    /**
+     * @brief Delete a child of the node. The node must be locked.
+     *
+     * @param index index of the child
      */
-    Node(Node *parent_node,
-         const Action &move,
-         const std::vector<Action> &possible_moves);
+    void delete_child(const int index);
+
+    /**
+     * @brief Move the child whose score changed to its place in the sorted children and
+     * update the ranks of the children it passes. The node must be locked.
+     *
+     * @param index index of the child
+     */
+    void move_child(const int index);
+
+    /**
+     * @brief Count the memory allocated or freed by a vector of a node
+     *
+     * @tparam T type of the elements of the vector
+     * @param old_capacity capacity of the vector before the modification
+     * @param vector the vector
+     */
+    template <typename T>
+    static void track_memory(const size_t old_capacity, const std::vector<T> &vector) {
+        vectors_memory +=
+            static_cast<long>((vector.capacity() - old_capacity) * sizeof(T));
+    }
+
+  public:
+    /**
+     * @brief Construct an empty node (slot of the pool)
+     *
+     */
+    Node() = default;
 
     /**
      * @brief Construct a copy of a Node object impossible
@@ -61,18 +165,114 @@ class Node {
     Node(const Node &) = delete;
 
     /**
-     * @brief Destroy the Node object
+     * @brief Create a root node
      *
+     * @param move Action that lead to the new node
+     * @param possible_moves possible actions that create new children to the node
+     * @return NodeLink link to the new node
      */
-    ~Node();
+    [[nodiscard]] static NodeLink create_root(const Action &move,
+                                              const std::vector<Action> &possible_moves);
 
     /**
-     * @brief Update the branch, recalculate the score and UCB score
-     * and increment the number of visits. Delete node that lead to no children
+     * @brief Create a new node and add it to the children of its parent, it ends the
+     * expansion of the move
      *
+     * @param parent parent node of the new node
+     * @param move Action that lead to the new node (given by next_child)
+     * @param possible_moves possible actions that create new children to the node
+     * @return NodeLink link to the new node, no node (index -1) if the parent has been
+     * deleted by another thread
+     */
+    [[nodiscard]] static NodeLink add_child(const NodeLink &parent,
+                                            const Action &move,
+                                            const std::vector<Action> &possible_moves);
+
+    /**
+     * @brief Delete the tree of the root node
+     *
+     * @param root root of the tree
+     */
+    static void delete_tree(const NodeLink &root);
+
+    /**
+     * @brief Collapse the least visited branches of the tree back into the possible
+     * moves of their parent (so they can be explored again later) until the tree has at
+     * most max_nodes nodes
+     *
+     * @param root root of the tree
+     * @param max_nodes maximal number of nodes of the tree
+     * @return long number of nodes of the tree
+     */
+    static long shrink_tree(const NodeLink &root, const long max_nodes);
+
+    /**
+     * @brief Return the node at the index of the pool
+     *
+     * @param index index of the node
+     * @return Node& the node
+     */
+    [[nodiscard]] static Node &get(const int index);
+
+    /**
+     * @brief Return true if the node of the link still exists. The node must be locked.
+     *
+     * @param link link to the node
+     * @return true the node exists
+     * @return false the node has been deleted
+     */
+    [[nodiscard]] static bool exists(const NodeLink &link);
+
+    /**
+     * @brief Update the node (if it still exists) and increment the number of visits.
+     * The child of the branch is deleted if it leads to no children, otherwise it is
+     * moved to its rank among its siblings. The UCB scores are computed during the
+     * selection. The branch is updated by calling update on each node from the leaf to
+     * the root.
+     *
+     * @param link link to the node
+     * @param child link to the child of the node in the branch (index -1 for the leaf)
      * @param score new score
+     * @param virtual_loss true to remove the virtual loss added on the node by the
+     * selection
      */
-    void update(const double &score);
+    static void update(const NodeLink &link,
+                       const NodeLink &child,
+                       const double &score,
+                       const bool virtual_loss);
+
+    /**
+     * @brief Remove the virtual loss added on the node by the selection (if the node
+     * still exists)
+     *
+     * @param link link to the node
+     */
+    static void remove_virtual_loss(const NodeLink &link);
+
+    /**
+     * @brief End the expansion of a move given by next_child that doesn't create a child
+     * (complete or pruned solution)
+     *
+     * @param link link to the node
+     */
+    static void end_expansion(const NodeLink &link);
+
+    /**
+     * @brief Return the mutex protecting the possible moves and the children of the node
+     *
+     * @return std::mutex& the mutex
+     */
+    [[nodiscard]] std::mutex &mutex() const;
+
+    /**
+     * @brief Return the child with the highest UCB score (random between ties) and add
+     * it a virtual loss. The UCB score is computed with the rank of the child and the
+     * number of visits. The UCB score of the children with virtual losses is lowered so
+     * the threads spread across the branches. The node must be locked.
+     *
+     * @return NodeLink the selected child, no node (index -1) if there is no child
+     */
+    [[nodiscard]] NodeLink best_child();
 
     /**
      * @brief Delete children and possible children if their score is equal or superior to
@@ -85,19 +285,12 @@ class Node {
     bool clean_graph(const int &score);
 
     /**
-     * @brief Return next action of the next child of the node
+     * @brief Return next action of the next child of the node. The node must be locked.
      *
      * @return const Action next child
      */
     [[nodiscard]] const Action next_child();
 
-    /**
-     * @brief Add child to its parent children
-     *
-     * @param child the child to add to its parent
-     */
-    void add_child_to_parent(const std::shared_ptr<Node> &child);
-
     /**
      * @brief Return the move that lead to the node
      *
@@ -106,18 +299,18 @@ class Node {
     [[nodiscard]] const Action &move() const;
 
     /**
-     * @brief Return the UCB score of the node
+     * @brief Return the UCB score of the node at its last selection
      *
      * @return const double& the UCB score
      */
     [[nodiscard]] const double &score_ucb() const;
 
     /**
-     * @brief Return the children of the node
+     * @brief Return the indexes of the children of the node
      *
-     * @return const std::vector<std::shared_ptr<Node>>& children node
+     * @return const std::vector<int>& children node
      */
-    [[nodiscard]] const std::vector<std::shared_ptr<Node>> &children_nodes();
+    [[nodiscard]] const std::vector<int> &children_nodes();
 
     /**
      * @brief Get the total number of nodes created
@@ -133,6 +326,23 @@ class Node {
      */
     [[nodiscard]] static long get_nb_current_nodes();
 
+    /**
+     * @brief Get the number of nodes allocated in the pool (existing or ready to be
+     * reused), the memory used by the trees is about this number times sizeof(Node) plus
+     * the possible moves and the children of the nodes
+     *
+     * @return long number of allocated nodes
+     */
+    [[nodiscard]] static long get_nb_allocated_nodes();
+
+    /**
+     * @brief Get the memory allocated by the pool of nodes (nodes and vectors of the
+     * nodes)
+     *
+     * @return long memory in bytes
+     */
+    [[nodiscard]] static long get_memory();
+
     /**
      * @brief Get the height of the tree
      *
@@ -148,7 +358,7 @@ class Node {
     [[nodiscard]] int get_depth();
 
     /**
-     * @brief A node is terminal if it has no possible child
+     * @brief A node is terminal if it has no possible child. The node must be locked.
      *
      * @return true the node has no child
      * @return false the node has at least one child
@@ -156,7 +366,8 @@ class Node {
     [[nodiscard]] bool terminal() const;
 
     /**
-     * @brief A node is fully explored if it has no child and no possible child
+     * @brief A node is fully explored if it has no child, no possible child and no
+     * expansion in progress
      *
      * @return true the node is fully explored
      * @return false the branch of the node can grow
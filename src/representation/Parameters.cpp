@@ -18,12 +18,21 @@ Parameters::Parameters(const std::string &problem_,
                        long nb_max_iterations_,
                        const std::string &initialization_,
                        long nb_iter_local_search_,
-                       int max_time_local_search_,
+                       double max_time_local_search_,
                        double coeff_exploi_explo_,
                        const std::string &local_search_,
                        const std::string &simulation_,
                        int O_time_,
                        double P_time_,
+                       int nb_threads_,
+                       const std::string &parallel_,
+                       long max_tree_nodes_,
+                       long max_tree_memory_,
+                       const std::string &local_search_selection_,
+                       long transposition_table_size_,
+                       int local_search_pool_,
+                       long local_search_slice_,
+                       const std::string &portfolio_,
                        const std::string &output_file_)
     : problem(problem_),
       instance(instance_),
@@ -34,7 +43,7 @@ Parameters::Parameters(const std::string &problem_,
       objective(objective_),
       time_start(std::chrono::high_resolution_clock::now()),
       time_limit(time_limit_),
-      time_stop(time_start + std::chrono::seconds(time_limit_)),
+      time_stop_ms(int64_t{time_limit_} * 1000),
       nb_max_iterations(nb_max_iterations_),
       initialization(initialization_),
       nb_iter_local_search(nb_iter_local_search_),
@@ -44,6 +53,15 @@ Parameters::Parameters(const std::string &problem_,
       simulation(simulation_),
       O_time(O_time_),
       P_time(P_time_),
+      nb_threads(nb_threads_),
+      parallel(parallel_),
+      max_tree_nodes(max_tree_nodes_),
+      max_tree_memory(max_tree_memory_),
+      local_search_selection(local_search_selection_),
+      transposition_table_size(transposition_table_size_),
+      local_search_pool(local_search_pool_),
+      local_search_slice(local_search_slice_),
+      portfolio(portfolio_),
       output_file(output_file_) {
     // set output file if needed
     if (output_file != "") {
@@ -73,25 +91,44 @@ Parameters::Parameters(const std::string &problem_,
                  "local_search,"
                  "simulation,"
                  "O_time,"
-                 "P_time";
-    line_csv = fmt::format("{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{}",
-                           problem,
-                           instance,
-                           method,
-                           rand_seed,
-                           target,
-                           use_target,
-                           objective,
-                           time_limit,
-                           nb_max_iterations,
-                           initialization,
-                           nb_iter_local_search,
-                           max_time_local_search,
-                           coeff_exploi_explo,
-                           local_search,
-                           simulation,
-                           O_time,
-                           P_time);
+                 "P_time,"
+                 "nb_threads,"
+                 "parallel,"
+                 "max_tree_nodes,"
+                 "max_tree_memory,"
+                 "local_search_selection,"
+                 "transposition_table_size,"
+                 "local_search_pool,"
+                 "local_search_slice,"
+                 "portfolio";
+    line_csv = fmt::format(
+        "{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{}",
+        problem,
+        instance,
+        method,
+        rand_seed,
+        target,
+        use_target,
+        objective,
+        time_limit,
+        nb_max_iterations,
+        initialization,
+        nb_iter_local_search,
+        max_time_local_search,
+        coeff_exploi_explo,
+        local_search,
+        simulation,
+        O_time,
+        P_time,
+        nb_threads,
+        parallel,
+        max_tree_nodes,
+        max_tree_memory,
+        local_search_selection,
+        transposition_table_size,
+        local_search_pool,
+        local_search_slice,
+        portfolio);
 }
 
 void Parameters::end_search() const {
@@ -106,23 +143,33 @@ void Parameters::end_search() const {
     }
 }
 
+void Parameters::stop_search() {
+    time_stop_ms = 0;
+}
+
 bool Parameters::time_limit_reached() const {
-    return not(std::chrono::duration_cast<std::chrono::seconds>(
-                   time_stop - std::chrono::high_resolution_clock::now())
-                   .count() >= 0);
+    return time_limit_reached(std::chrono::high_resolution_clock::now());
+}
+
+bool Parameters::time_limit_reached(
+    const std::chrono::high_resolution_clock::time_point &now) const {
+    return elapsed_time_ms(now) >= time_stop_ms.load(std::memory_order_relaxed);
 }
 
 bool Parameters::time_limit_reached_sub_method(
     const std::chrono::high_resolution_clock::time_point &time) const {
-    return not(std::chrono::duration_cast<std::chrono::seconds>(
-                   time - std::chrono::high_resolution_clock::now())
-                   .count() >= 0) or
-           not(std::chrono::duration_cast<std::chrono::seconds>(
-                   time_stop - std::chrono::high_resolution_clock::now())
-                   .count() >= 0);
+    // only one read of the clock
+    const auto now{std::chrono::high_resolution_clock::now()};
+    return now >= time or time_limit_reached(now);
 }
 
 int64_t Parameters::elapsed_time(
     const std::chrono::high_resolution_clock::time_point &time) const {
     return std::chrono::duration_cast<std::chrono::seconds>(time - time_start).count();
 }
+
+int64_t Parameters::elapsed_time_ms(
+    const std::chrono::high_resolution_clock::time_point &time) const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time - time_start)
+        .count();
+}
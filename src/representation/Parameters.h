@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <vector>
@@ -23,17 +24,27 @@ struct Parameters {
     const std::string objective;
     const std::chrono::high_resolution_clock::time_point time_start;
     const int time_limit;
-    std::chrono::high_resolution_clock::time_point
-        time_stop; /** @brief time limit for the algorithm, can be set to now to stop*/
+    /** @brief time limit for the algorithm in milliseconds since the start, set to 0 by
+     * stop_search to stop (atomic, can be set by a signal or another thread)*/
+    std::atomic<int64_t> time_stop_ms;
     const long nb_max_iterations; /** @brief Number of iteration maximum for the MCTS*/
     const std::string initialization;
     const long nb_iter_local_search;
-    const int max_time_local_search;
+    const double max_time_local_search; /** @brief Time limit of the local searches (s)*/
     const double coeff_exploi_explo;
     const std::string local_search;
     const std::string simulation;
     const int O_time;
     const double P_time;
+    const int nb_threads; /** @brief Number of threads (MCTS workers)*/
+    const std::string parallel; /** @brief Parallelization of the MCTS (root, tree)*/
+    const long max_tree_nodes;  /** @brief Maximal number of nodes of the MCTS trees*/
+    const long max_tree_memory; /** @brief Maximal memory of the MCTS trees (MB)*/
+    const std::string local_search_selection; /** @brief Bandit over local searches*/
+    const long transposition_table_size; /** @brief Entries of the transposition table*/
+    const int local_search_pool;   /** @brief Suspended local searches per MCTS thread*/
+    const long local_search_slice; /** @brief Turns of a local search between switches*/
+    const std::string portfolio; /** @brief Searches of the workers of the portfolio*/
     const std::string output_file; /** @brief Output file name if not on console*/
     std::FILE *output{nullptr};    /** @brief Output, stdout if console*/
     std::string header_csv{};
@@ -60,12 +71,21 @@ struct Parameters {
                         long nb_max_iterations_,
                         const std::string &initialization_,
                         long nb_iter_local_search_,
-                        int max_time_local_search_,
+                        double max_time_local_search_,
                         double coeff_exploi_explo_,
                         const std::string &local_search_,
                         const std::string &simulation_,
                         int O_time_,
                         double P_time_,
+                        int nb_threads_,
+                        const std::string &parallel_,
+                        long max_tree_nodes_,
+                        long max_tree_memory_,
+                        const std::string &local_search_selection_,
+                        long transposition_table_size_,
+                        int local_search_pool_,
+                        long local_search_slice_,
+                        const std::string &portfolio_,
                         const std::string &output_file_);
 
     /**
@@ -74,6 +94,12 @@ struct Parameters {
      */
     void end_search() const;
 
+    /**
+     * @brief Stop the search, the time limit is considered as reached
+     *
+     */
+    void stop_search();
+
     /**
      * @brief Return true if the time limit is reached
      *
@@ -82,6 +108,16 @@ struct Parameters {
      */
     bool time_limit_reached() const;
 
+    /**
+     * @brief Return true if the time limit is reached at the given time
+     *
+     * @param now given time (std::chrono::high_resolution_clock::now())
+     * @return true Time limit is reached
+     * @return false The search continue
+     */
+    bool
+    time_limit_reached(const std::chrono::high_resolution_clock::time_point &now) const;
+
     /**
      * @brief Return true if the time limit is reached according to the given time
      *
@@ -100,4 +136,14 @@ struct Parameters {
      */
     int64_t
     elapsed_time(const std::chrono::high_resolution_clock::time_point &time) const;
+
+    /**
+     * @brief Returns the number of milliseconds between the given time and the start of
+     * the search
+     *
+     * @param time given time (std::chrono::high_resolution_clock::now())
+     * @return int64_t elapsed time in milliseconds
+     */
+    int64_t
+    elapsed_time_ms(const std::chrono::high_resolution_clock::time_point &time) const;
 };
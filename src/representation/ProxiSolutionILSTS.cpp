@@ -1,14 +1,30 @@
 #include "ProxiSolutionILSTS.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "../utils/random_generator.h"
 
-ProxiSolutionILSTS::ProxiSolutionILSTS(Solution solution)
-    : _solution(solution),
-      _nb_free_colors(Graph::g->nb_vertices, 0),
-      _unassigned_score(solution.score_wvcp()) {
+ProxiSolutionILSTS::ProxiSolutionILSTS(Solution solution) : _solution(solution) {
+    init_structures();
+}
+
+void ProxiSolutionILSTS::reset(const Solution &solution) {
+    _solution = solution;
+    init_structures();
+}
+
+void ProxiSolutionILSTS::init_structures() {
+    _nb_free_colors.assign(Graph::g->nb_vertices, 0);
+    _unassigned_score = _solution.score_wvcp();
+    _unassigned.clear();
+    _colors_bitsets.assign(static_cast<size_t>(_solution.nb_colors()) *
+                               static_cast<size_t>(Graph::g->nb_words),
+                           0);
     for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
+        if (_solution.color(vertex) != -1) {
+            Graph::add_to_bitset(color_bitset(_solution.color(vertex)), vertex);
+        }
         for (int color{0}; color < _solution.nb_colors(); ++color) {
             if (_solution.conflicts_colors(color, vertex) == 0 and
                 color != _solution.color(vertex) and
@@ -42,6 +58,21 @@ bool ProxiSolutionILSTS::check_solution() const {
         assert(_nb_free_colors[vertex] == free_color);
     }
     assert(unassigned == static_cast<int>(_unassigned.size()));
+    for (int color{0}; color < _solution.nb_colors(); ++color) {
+        const uint64_t *bitset{_colors_bitsets.data() +
+                               static_cast<size_t>(color) *
+                                   static_cast<size_t>(Graph::g->nb_words)};
+        int nb_vertices{0};
+        for (int word{0}; word < Graph::g->nb_words; ++word) {
+            nb_vertices += __builtin_popcountll(bitset[word]);
+        }
+        assert(nb_vertices ==
+               static_cast<int>(_solution.colors_vertices(color).size()));
+        for (const int vertex : _solution.colors_vertices(color)) {
+            (void)vertex;
+            assert((bitset[vertex >> 6] >> (vertex & 63)) & 1);
+        }
+    }
 
     return _solution.check_solution();
 }
@@ -50,10 +81,14 @@ int ProxiSolutionILSTS::add_to_color(const int vertex, const int color_proposed)
 
     const int old_max_weight = _solution.max_weight(color_proposed);
 
+    if (_solution.color(vertex) != -1) {
+        Graph::remove_from_bitset(color_bitset(_solution.color(vertex)), vertex);
+    }
     const int color{_solution.add_to_color(vertex, color_proposed)};
+    Graph::add_to_bitset(color_bitset(color), vertex);
 
     // update free colors for neighbors
-    for (const auto &neighbor : Graph::g->neighborhood[vertex]) {
+    for (const auto &neighbor : Graph::g->neighbors(vertex)) {
         if (_solution.conflicts_colors(color, neighbor) == 1 and
             Graph::g->weights[neighbor] <= old_max_weight) {
             _nb_free_colors[neighbor]--;
@@ -63,13 +98,11 @@ int ProxiSolutionILSTS::add_to_color(const int vertex, const int color_proposed)
     // update nb free colors
     // if the vertex increase the class weight
     if (Graph::g->weights[vertex] > old_max_weight) {
-        // for all vertices outside the color -> 9s -> 165
-        for (int vertex_out{0}; vertex_out < Graph::g->nb_vertices; ++vertex_out) {
-            if (_solution.color(vertex_out) == color) {
-                continue;
-            }
-            if (Graph::g->weights[vertex_out] > old_max_weight and
-                Graph::g->weights[vertex_out] <= Graph::g->weights[vertex] and
+        // only the vertices outside the color with a weight between the old and the new
+        // max weight of the color gain the color
+        for (const int vertex_out : Graph::g->vertices_between_weights(
+                 old_max_weight, Graph::g->weights[vertex])) {
+            if (_solution.color(vertex_out) != color and
                 _solution.conflicts_colors(color, vertex_out) == 0) {
                 // update its number of free colors
                 ++_nb_free_colors[vertex_out];
@@ -86,9 +119,10 @@ int ProxiSolutionILSTS::delete_from_color(const int vertex) {
 
     const int old_weight{max_weight(_solution.color(vertex))};
     const int color{_solution.delete_from_color(vertex)};
+    Graph::remove_from_bitset(color_bitset(color), vertex);
 
     // update free color for neighbors
-    for (const int neighbor : Graph::g->neighborhood[vertex]) {
+    for (const int neighbor : Graph::g->neighbors(vertex)) {
         if (_solution.conflicts_colors(color, neighbor) == 0 and
             Graph::g->weights[neighbor] <= old_weight) {
             ++_nb_free_colors[neighbor];
@@ -101,13 +135,11 @@ int ProxiSolutionILSTS::delete_from_color(const int vertex) {
 
     // update free colors
     if (vertex_weight == old_weight) {
-        for (int vertex_out{0}; vertex_out < Graph::g->nb_vertices; ++vertex_out) {
-            if (_solution.color(vertex_out) == color) {
-                continue;
-            }
-
-            if (Graph::g->weights[vertex_out] <= old_weight and
-                Graph::g->weights[vertex_out] > max_weight_color and
+        // only the vertices outside the color with a weight between the new and the old
+        // max weight of the color lose the color
+        for (const int vertex_out :
+             Graph::g->vertices_between_weights(max_weight_color, old_weight)) {
+            if (_solution.color(vertex_out) != color and
                 _solution.conflicts_colors(color, vertex_out) == 0 and
                 vertex != vertex_out) {
                 --_nb_free_colors[vertex_out];
@@ -121,12 +153,30 @@ int ProxiSolutionILSTS::delete_from_color(const int vertex) {
     return color;
 }
 
+uint64_t *ProxiSolutionILSTS::color_bitset(const int color) {
+    const size_t first{static_cast<size_t>(color) *
+                       static_cast<size_t>(Graph::g->nb_words)};
+    if (_colors_bitsets.size() <= first) {
+        _colors_bitsets.resize(first + static_cast<size_t>(Graph::g->nb_words), 0);
+    }
+    return _colors_bitsets.data() + first;
+}
+
+void ProxiSolutionILSTS::neighbors_in_color(const int vertex,
+                                            const int color,
+                                            std::vector<int> &neighbors) const {
+    Graph::g->neighbors_in(vertex,
+                           _colors_bitsets.data() +
+                               static_cast<size_t>(color) *
+                                   static_cast<size_t>(Graph::g->nb_words),
+                           neighbors);
+}
+
 [[nodiscard]] int ProxiSolutionILSTS::unassigned_score() const {
     return _unassigned_score;
 }
 
 void ProxiSolutionILSTS::unassigned_random_heavy_vertices(const int force) {
-    std::uniform_int_distribution<int> distribution(0, _solution.nb_colors() - 1);
     std::vector<int> unassigned;
     _unassigned_score = _solution.score_wvcp();
     for (int i = 0; i < force; ++i) {
@@ -139,6 +189,8 @@ void ProxiSolutionILSTS::unassigned_random_heavy_vertices(const int force) {
                 to_unassign.push_back(vertex);
             }
         }
+        // the vertices of a color are unordered
+        std::sort(to_unassign.begin(), to_unassign.end());
         for (const auto &vertex : to_unassign) {
             delete_from_color(vertex);
             unassigned.push_back(vertex);
@@ -155,25 +207,20 @@ void ProxiSolutionILSTS::unassigned_random_heavy_vertices(const int force) {
 
 void ProxiSolutionILSTS::perturb_vertices(const int force) {
     assert(_unassigned.empty());
-    std::uniform_int_distribution<int> distribution_v(0, Graph::g->nb_vertices - 1);
-    std::uniform_int_distribution<int> distribution_c(0, _solution.nb_colors() - 1);
-
     for (int i = 0; i < force; ++i) {
         int vertex{0};
         int color{_solution.color(vertex)};
         while (_solution.color(vertex) == color) {
-            vertex = distribution_v(rd::generator);
+            vertex = rd::uniform(0, Graph::g->nb_vertices - 1);
             color = rd::choice(_solution.non_empty_colors());
         }
 
         delete_from_color(vertex);
 
         std::vector<int> unassigned;
-        for (const int neighbor : Graph::g->neighborhood[vertex]) {
-            if (_solution.color(neighbor) == color) {
-                unassigned.push_back(neighbor);
-                delete_from_color(neighbor);
-            }
+        neighbors_in_color(vertex, color, unassigned);
+        for (const int neighbor : unassigned) {
+            delete_from_color(neighbor);
         }
 
         if (_solution.is_color_empty(color)) {
@@ -20,11 +20,38 @@ class ProxiSolutionILSTS {
     int _unassigned_score{0};
     /** @brief List of unassigned vertices*/
     std::vector<int> _unassigned{};
+    /** @brief For each color, bitset of its vertices (Graph::g->nb_words words per
+     * color)*/
+    Bitset _colors_bitsets{};
+
+    /**
+     * @brief Return the bitset of the vertices of the color, the bitsets grow with the
+     * colors of the solution
+     *
+     * @param color the color
+     * @return uint64_t* first word of the bitset of the color
+     */
+    uint64_t *color_bitset(const int color);
+
+    /**
+     * @brief Init the numbers of free colors and the unassigned vertices from the
+     * solution (the buffers are reused)
+     *
+     */
+    void init_structures();
 
   public:
     ProxiSolutionILSTS() = delete;
     ProxiSolutionILSTS(Solution solution);
 
+    /**
+     * @brief Restart the proxi solution from the solution, without reallocating its
+     * buffers
+     *
+     * @param solution the solution
+     */
+    void reset(const Solution &solution);
+
     bool check_solution() const;
 
     /**
@@ -48,6 +75,19 @@ class ProxiSolutionILSTS {
      */
     int delete_from_color(const int vertex);
 
+    /**
+     * @brief Give the neighbors of the vertex in the color by increasing number (same
+     * order as Graph::g->neighbors)
+     *
+     * @param vertex the vertex
+     * @param color the color
+     * @param neighbors the neighbors of the vertex in the color, the vector is cleared
+     * first
+     */
+    void neighbors_in_color(const int vertex,
+                            const int color,
+                            std::vector<int> &neighbors) const;
+
     /**
      * @brief Gives the unassigned score of the solution
      *
@@ -1,16 +1,55 @@
 #include "ProxiSolutionRedLS.h"
 
+#include <algorithm>
 #include <cassert>
 
-ProxiSolutionRedLS::ProxiSolutionRedLS(Solution solution)
-    : _solution(solution),
-      _conflicts_colors(solution.conflicts_colors()),
-      _edge_weights(Graph::g->nb_vertices, std::vector<int>(Graph::g->nb_vertices, 0)) {
-    // init _edge_weights
-    for (const auto &[v1, v2] : Graph::g->edges_list) {
-        _edge_weights[v1][v2] = 1;
-        _edge_weights[v2][v1] = 1;
+ProxiSolutionRedLS::ProxiSolutionRedLS(Solution solution) : _solution(solution) {
+    init_structures();
+}
+
+void ProxiSolutionRedLS::reset(const Solution &solution) {
+    _solution = solution;
+    init_structures();
+}
+
+void ProxiSolutionRedLS::init_structures() {
+    _penalty = 0;
+    _conflicts_colors.resize(_solution.nb_colors());
+    for (int color{0}; color < _solution.nb_colors(); ++color) {
+        const Span<const int> conflicts{_solution.conflicts_colors(color)};
+        _conflicts_colors[color].assign(conflicts.begin(), conflicts.end());
+    }
+    _conflict_edges.clear();
+    _conflict_edges_ids.clear();
+    _conflict_edges_positions.assign(Graph::g->neighbors_targets.size(), -1);
+    _edge_weights.assign(Graph::g->neighbors_targets.size(), 1);
+}
+
+[[nodiscard]] int ProxiSolutionRedLS::edge_id(const int vertex, const int index) {
+    if (vertex < Graph::g->neighbors_targets[index]) {
+        return index;
     }
+    return Graph::g->reverse_neighbors[index];
+}
+
+void ProxiSolutionRedLS::add_conflict_edge(const int vertex, const int index) {
+    const int id{edge_id(vertex, index)};
+    const int neighbor{Graph::g->neighbors_targets[index]};
+    _conflict_edges_positions[id] = static_cast<int>(_conflict_edges.size());
+    _conflict_edges.emplace_back(std::min(vertex, neighbor), std::max(vertex, neighbor));
+    _conflict_edges_ids.push_back(id);
+}
+
+void ProxiSolutionRedLS::remove_conflict_edge(const int vertex, const int index) {
+    const int id{edge_id(vertex, index)};
+    const int position{_conflict_edges_positions[id]};
+    const int last_id{_conflict_edges_ids.back()};
+    _conflict_edges[position] = _conflict_edges.back();
+    _conflict_edges_ids[position] = last_id;
+    _conflict_edges_positions[last_id] = position;
+    _conflict_edges.pop_back();
+    _conflict_edges_ids.pop_back();
+    _conflict_edges_positions[id] = -1;
 }
 
 int ProxiSolutionRedLS::add_to_color(const int vertex, const int proposed_color) {
@@ -19,20 +58,22 @@ int ProxiSolutionRedLS::add_to_color(const int vertex, const int proposed_color)
         _conflicts_colors.emplace_back(Graph::g->nb_vertices, 0);
     }
 
+    const int first{Graph::g->neighbors_offsets[vertex]};
+    const int last{Graph::g->neighbors_offsets[vertex + 1]};
+    const int *neighbors{Graph::g->neighbors_targets.data()};
     if (_conflicts_colors[color][vertex] > 0) {
         // Update penalty
         _penalty += _conflicts_colors[color][vertex];
-        for (const auto &neighbor : Graph::g->neighborhood[vertex]) {
-            if (_solution.color(neighbor) == color) {
-                const int lower{std::min(neighbor, vertex)};
-                const int higher{std::max(neighbor, vertex)};
-                _conflict_edges.emplace_back(std::make_tuple(lower, higher));
+        for (int i{first}; i < last; ++i) {
+            if (_solution.color(neighbors[i]) == color) {
+                add_conflict_edge(vertex, i);
             }
         }
     }
     // update conflicts for neighbors
-    for (const auto &neighbor : Graph::g->neighborhood[vertex]) {
-        _conflicts_colors[color][neighbor] += _edge_weights[vertex][neighbor];
+    int *conflicts{_conflicts_colors[color].data()};
+    for (int i{first}; i < last; ++i) {
+        conflicts[neighbors[i]] += _edge_weights[i];
     }
 
     return color;
@@ -41,38 +82,34 @@ int ProxiSolutionRedLS::add_to_color(const int vertex, const int proposed_color)
 int ProxiSolutionRedLS::delete_from_color(const int vertex) {
     const int color = _solution.color(vertex);
 
+    const int first{Graph::g->neighbors_offsets[vertex]};
+    const int last{Graph::g->neighbors_offsets[vertex + 1]};
+    const int *neighbors{Graph::g->neighbors_targets.data()};
     // Update nb of conflicts and list of conflicting edges
     if (_conflicts_colors[color][vertex] > 0) {
         _penalty -= _conflicts_colors[color][vertex];
-        for (const auto &neighbor : Graph::g->neighborhood[vertex]) {
-            if (_solution.color(neighbor) == color) {
-                const int lower{std::min(neighbor, vertex)};
-                const int higher{std::max(neighbor, vertex)};
-                int index{0};
-                for (const auto &[edge1, edge2] : _conflict_edges) {
-                    if (edge1 == lower and edge2 == higher) {
-                        break;
-                    }
-                    index++;
-                }
-                _conflict_edges.erase(_conflict_edges.begin() + index);
+        for (int i{first}; i < last; ++i) {
+            if (_solution.color(neighbors[i]) == color) {
+                remove_conflict_edge(vertex, i);
             }
         }
     }
 
     // update conflicts for neighbors
-    for (const int neighbor : Graph::g->neighborhood[vertex]) {
-        // _conflicts_colors[color][neighbor]--;
-        _conflicts_colors[color][neighbor] -= _edge_weights[vertex][neighbor];
+    int *conflicts{_conflicts_colors[color].data()};
+    for (int i{first}; i < last; ++i) {
+        conflicts[neighbors[i]] -= _edge_weights[i];
     }
 
     return _solution.delete_from_color(vertex);
 }
 
 void ProxiSolutionRedLS::increment_edge_weights() {
-    for (const auto &[edge1, edge2] : _conflict_edges) {
-        ++_edge_weights[edge1][edge2];
-        ++_edge_weights[edge2][edge1];
+    for (size_t position{0}; position < _conflict_edges.size(); ++position) {
+        const auto &[edge1, edge2] = _conflict_edges[position];
+        const int id{_conflict_edges_ids[position]};
+        ++_edge_weights[id];
+        ++_edge_weights[Graph::g->reverse_neighbors[id]];
         ++_conflicts_colors[_solution.color(edge1)][edge2];
         ++_conflicts_colors[_solution.color(edge2)][edge1];
     }
@@ -80,23 +117,37 @@ void ProxiSolutionRedLS::increment_edge_weights() {
 }
 
 bool ProxiSolutionRedLS::check_solution() const {
+    int nb_conflict_edges{0};
     for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
         const int color{_solution.color(vertex)};
-        for (const auto &neighbor : Graph::g->neighborhood[vertex]) {
-            if (_solution.color(neighbor) == color) {
-                const int lower{std::min(neighbor, vertex)};
-                const int higher{std::max(neighbor, vertex)};
-                int index{0};
-                for (const auto &[edge1, edge2] : _conflict_edges) {
-                    if (edge1 == lower and edge2 == higher) {
-                        break;
-                    }
-                    index++;
-                }
-                assert(index < static_cast<int>(_conflict_edges.size()));
+        for (int i{Graph::g->neighbors_offsets[vertex]};
+             i < Graph::g->neighbors_offsets[vertex + 1];
+             ++i) {
+            const int neighbor{Graph::g->neighbors_targets[i]};
+            assert(Graph::g->neighbors_targets[Graph::g->reverse_neighbors[i]] == vertex);
+            assert(_edge_weights[i] == _edge_weights[Graph::g->reverse_neighbors[i]]);
+            if (vertex > neighbor) {
+                continue;
+            }
+            const bool conflicting{_solution.color(neighbor) == color};
+            assert((_conflict_edges_positions[i] != -1) == conflicting);
+            if (conflicting) {
+                ++nb_conflict_edges;
             }
         }
     }
+    assert(nb_conflict_edges == static_cast<int>(_conflict_edges.size()));
+    for (int position{0}; position < nb_conflict_edges; ++position) {
+        assert(_conflict_edges_positions[_conflict_edges_ids[position]] == position);
+        // the id is the edge from the lower vertex to the higher vertex
+        assert(std::get<0>(_conflict_edges[position]) <
+               std::get<1>(_conflict_edges[position]));
+        assert(Graph::g->neighbors_targets[_conflict_edges_ids[position]] ==
+               std::get<1>(_conflict_edges[position]));
+        assert(Graph::g->neighbors_targets
+                   [Graph::g->reverse_neighbors[_conflict_edges_ids[position]]] ==
+               std::get<0>(_conflict_edges[position]));
+    }
     return _solution.check_solution();
 }
 
@@ -111,11 +162,17 @@ bool ProxiSolutionRedLS::check_solution() const {
     return _conflicts_colors[color][vertex];
 }
 
+[[nodiscard]] Span<const int>
+ProxiSolutionRedLS::conflicts_colors(const int color) const {
+    const std::vector<int> &conflicts{_conflicts_colors[color]};
+    return {conflicts.data(), conflicts.data() + conflicts.size()};
+}
+
 [[nodiscard]] int ProxiSolutionRedLS::penalty() const {
     return _penalty;
 }
 
-[[nodiscard]] std::vector<std::tuple<int, int>>
+[[nodiscard]] const std::vector<std::tuple<int, int>> &
 ProxiSolutionRedLS::conflict_edges() const {
     return _conflict_edges;
 }
@@ -128,10 +185,18 @@ int ProxiSolutionRedLS::delta_wvcp_score(const int vertex, const int color) cons
     return _solution.delta_wvcp_score(vertex, color);
 }
 
+[[nodiscard]] int ProxiSolutionRedLS::delta_wvcp_score_old_color(const int vertex) const {
+    return _solution.delta_wvcp_score_old_color(vertex);
+}
+
 [[nodiscard]] const std::vector<int> &ProxiSolutionRedLS::non_empty_colors() const {
     return _solution.non_empty_colors();
 }
 
+[[nodiscard]] const std::vector<int> &ProxiSolutionRedLS::colors() const {
+    return _solution.colors();
+}
+
 [[nodiscard]] int ProxiSolutionRedLS::color(const int &vertex) const {
     return _solution.color(vertex);
 }
@@ -144,7 +209,7 @@ int ProxiSolutionRedLS::delta_wvcp_score(const int vertex, const int color) cons
     return _solution.has_conflicts(vertex);
 }
 
-[[nodiscard]] const std::set<int> &
+[[nodiscard]] const std::vector<int> &
 ProxiSolutionRedLS::colors_vertices(const int &color) const {
     return _solution.colors_vertices(color);
 }
@@ -18,15 +18,62 @@ class ProxiSolutionRedLS {
     /** @brief For each color, for each vertex, number of neighbors in the color*/
     std::vector<std::vector<int>> _conflicts_colors{};
 
-    /** @brief list of conflicting edges in the solution*/
+    /** @brief list of conflicting edges in the solution (unordered)*/
     std::vector<std::tuple<int, int>> _conflict_edges{};
-    /** @brief edge weights (for RedLS)*/
-    std::vector<std::vector<int>> _edge_weights{};
+    /** @brief For each conflicting edge, its id (see edge_id)*/
+    std::vector<int> _conflict_edges_ids{};
+    /** @brief For each edge id, position of the edge in the conflicting edges (-1 if
+     * the edge isn't conflicting)*/
+    std::vector<int> _conflict_edges_positions{};
+    /** @brief edge weights (for RedLS), for each index of Graph::neighbors_targets
+     * (both directions of an edge have the same weight)*/
+    std::vector<int> _edge_weights{};
+
+    /**
+     * @brief Return the id of the edge, its index in the neighbors of its lower vertex
+     * (see Graph::neighbors_targets)
+     *
+     * @param vertex first vertex of the edge
+     * @param index index of the edge from the vertex in Graph::neighbors_targets
+     * @return int the id of the edge
+     */
+    [[nodiscard]] static int edge_id(const int vertex, const int index);
+
+    /**
+     * @brief Add the edge to the conflicting edges
+     *
+     * @param vertex first vertex of the edge
+     * @param index index of the edge from the vertex in Graph::neighbors_targets
+     */
+    void add_conflict_edge(const int vertex, const int index);
+
+    /**
+     * @brief Remove the edge from the conflicting edges (the last edge takes its place)
+     *
+     * @param vertex first vertex of the edge
+     * @param index index of the edge from the vertex in Graph::neighbors_targets
+     */
+    void remove_conflict_edge(const int vertex, const int index);
+
+    /**
+     * @brief Init the conflicts, the conflicting edges and the edge weights from the
+     * solution (the buffers are reused)
+     *
+     */
+    void init_structures();
 
   public:
     ProxiSolutionRedLS() = delete;
     ProxiSolutionRedLS(Solution solution);
 
+    /**
+     * @brief Restart the proxi solution from the solution, without reallocating its
+     * buffers
+     *
+     * @param solution the solution
+     */
+    void reset(const Solution &solution);
+
     int add_to_color(const int vertex, const int proposed_color);
 
     int delete_from_color(const int vertex);
@@ -39,9 +86,11 @@ class ProxiSolutionRedLS {
 
     [[nodiscard]] int conflicts_colors(const int &color, const int &vertex) const;
 
+    [[nodiscard]] Span<const int> conflicts_colors(const int color) const;
+
     [[nodiscard]] int penalty() const;
 
-    [[nodiscard]] std::vector<std::tuple<int, int>> conflict_edges() const;
+    [[nodiscard]] const std::vector<std::tuple<int, int>> &conflict_edges() const;
 
     [[nodiscard]] Solution solution() const;
 
@@ -49,15 +98,19 @@ class ProxiSolutionRedLS {
 
     int delta_wvcp_score(const int vertex, const int color) const;
 
+    [[nodiscard]] int delta_wvcp_score_old_color(const int vertex) const;
+
     [[nodiscard]] const std::vector<int> &non_empty_colors() const;
 
+    [[nodiscard]] const std::vector<int> &colors() const;
+
     [[nodiscard]] int color(const int &vertex) const;
 
     [[nodiscard]] int score_wvcp() const;
 
     [[nodiscard]] bool has_conflicts(const int vertex) const;
 
-    [[nodiscard]] const std::set<int> &colors_vertices(const int &color) const;
+    [[nodiscard]] const std::vector<int> &colors_vertices(const int &color) const;
 
     [[nodiscard]] int max_weight(const int &color) const;
 
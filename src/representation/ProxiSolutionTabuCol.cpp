@@ -0,0 +1,237 @@
+#include "ProxiSolutionTabuCol.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "../utils/best_move_selector.h"
+
+ProxiSolutionTabuCol::ProxiSolutionTabuCol(const Solution &solution)
+    : _solution(solution) {
+    init_structures();
+}
+
+void ProxiSolutionTabuCol::reset(const Solution &solution) {
+    _solution = solution;
+    init_structures();
+}
+
+void ProxiSolutionTabuCol::init_structures() {
+    _nb_colors = _solution.nb_colors();
+    const size_t nb_moves{static_cast<size_t>(Graph::g->nb_vertices) * _nb_colors};
+    _tabu.assign(nb_moves, 0);
+    _tabu_offset = 0;
+    _last_tabu = 0;
+    _target_colors.assign(_nb_colors, false);
+    _conflicting_vertices.clear();
+    _conflicting_positions.assign(Graph::g->nb_vertices, -1);
+    _buckets_first.assign(Graph::g->neighbors_offsets.back() + Graph::g->nb_vertices, -1);
+    _lowest_buckets.resize(Graph::g->nb_vertices);
+    _moves_buckets.assign(nb_moves, -1);
+    _moves_previous.assign(nb_moves, -1);
+    _moves_next.assign(nb_moves, -1);
+    for (const int color : _solution.non_empty_colors()) {
+        _target_colors[color] = true;
+    }
+    for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
+        update_conflicting(vertex);
+    }
+}
+
+void ProxiSolutionTabuCol::remove_one_color_and_create_conflicts() {
+    // same choice as Solution::remove_one_color_and_create_conflicts but the vertices
+    // are moved with move to update the moves
+    int best_sum_conflicts = Graph::g->nb_vertices;
+    int best_color1 = -1;
+    int best_color2 = -1;
+    for (const auto &color1 : _solution.non_empty_colors()) {
+        for (const auto &color2 : _solution.non_empty_colors()) {
+            if (color1 == color2) {
+                continue;
+            }
+            const int *conflicts_color2{_solution.conflicts_colors(color2).begin()};
+            int sum_conflicts{0};
+            for (const int vertex : _solution.colors_vertices(color1)) {
+                sum_conflicts += conflicts_color2[vertex];
+            }
+            if (sum_conflicts < best_sum_conflicts) {
+                best_color1 = color1;
+                best_color2 = color2;
+                best_sum_conflicts = sum_conflicts;
+            }
+        }
+    }
+    const auto to_delete = _solution.colors_vertices(best_color1);
+    for (const auto vertex : to_delete) {
+        move(vertex, best_color2);
+    }
+}
+
+void ProxiSolutionTabuCol::update_conflicting(const int vertex) {
+    const int color{_solution.color(vertex)};
+    const bool conflicting{_solution.conflicts_colors(color, vertex) > 0};
+    int &position{_conflicting_positions[vertex]};
+    if (conflicting and position == -1) {
+        position = static_cast<int>(_conflicting_vertices.size());
+        _conflicting_vertices.push_back(vertex);
+        // after the last bucket of the vertex
+        _lowest_buckets[vertex] = Graph::g->neighbors_offsets[vertex + 1] + vertex + 1;
+        for (const int target_color : _solution.non_empty_colors()) {
+            if (target_color != color) {
+                insert_move(vertex, target_color);
+            }
+        }
+    } else if (not conflicting and position != -1) {
+        const int last_vertex{_conflicting_vertices.back()};
+        _conflicting_vertices[position] = last_vertex;
+        _conflicting_positions[last_vertex] = position;
+        _conflicting_vertices.pop_back();
+        position = -1;
+        for (int other_color{0}; other_color < _nb_colors; ++other_color) {
+            remove_move(vertex, other_color);
+        }
+    }
+}
+
+void ProxiSolutionTabuCol::insert_move(const int vertex, const int color) {
+    const int move{vertex * _nb_colors + color};
+    const int bucket{Graph::g->neighbors_offsets[vertex] + vertex +
+                     _solution.conflicts_colors(color, vertex)};
+    const int first_move{_buckets_first[bucket]};
+    _moves_buckets[move] = bucket;
+    _moves_previous[move] = -1;
+    _moves_next[move] = first_move;
+    if (first_move != -1) {
+        _moves_previous[first_move] = move;
+    }
+    _buckets_first[bucket] = move;
+    _lowest_buckets[vertex] = std::min(_lowest_buckets[vertex], bucket);
+}
+
+void ProxiSolutionTabuCol::remove_move(const int vertex, const int color) {
+    const int move{vertex * _nb_colors + color};
+    const int bucket{_moves_buckets[move]};
+    if (bucket == -1) {
+        return;
+    }
+    const int previous_move{_moves_previous[move]};
+    const int next_move{_moves_next[move]};
+    if (previous_move == -1) {
+        _buckets_first[bucket] = next_move;
+    } else {
+        _moves_next[previous_move] = next_move;
+    }
+    if (next_move != -1) {
+        _moves_previous[next_move] = previous_move;
+    }
+    _moves_buckets[move] = -1;
+}
+
+void ProxiSolutionTabuCol::update_bucket(const int vertex, const int color) {
+    if (_moves_buckets[vertex * _nb_colors + color] == -1) {
+        return;
+    }
+    remove_move(vertex, color);
+    insert_move(vertex, color);
+}
+
+int ProxiSolutionTabuCol::move(const int vertex, const int color) {
+    assert(_target_colors[color]);
+    const int old_color{_solution.delete_from_color(vertex)};
+    _solution.add_to_color(vertex, color);
+
+    if (_solution.is_color_empty(old_color)) {
+        // the color can't be used anymore
+        _target_colors[old_color] = false;
+        for (const int conflicting_vertex : _conflicting_vertices) {
+            remove_move(conflicting_vertex, old_color);
+        }
+    }
+
+    const bool was_conflicting{_conflicting_positions[vertex] != -1};
+    remove_move(vertex, color);
+    update_conflicting(vertex);
+    if (was_conflicting and _conflicting_positions[vertex] != -1 and
+        _target_colors[old_color]) {
+        insert_move(vertex, old_color);
+    }
+
+    // the solution already updated the numbers of neighbors of the neighbors
+    for (const int neighbor : Graph::g->neighbors(vertex)) {
+        update_bucket(neighbor, old_color);
+        update_bucket(neighbor, color);
+        const int neighbor_color{_solution.color(neighbor)};
+        if (neighbor_color == old_color or neighbor_color == color) {
+            update_conflicting(neighbor);
+        }
+    }
+    return old_color;
+}
+
+void ProxiSolutionTabuCol::clear_tabu() {
+    _tabu_offset = _last_tabu + 1;
+}
+
+void ProxiSolutionTabuCol::set_tabu(const int vertex,
+                                    const int color,
+                                    const long iteration) {
+    long &tabu{_tabu[vertex * _nb_colors + color]};
+    tabu = _tabu_offset + iteration;
+    _last_tabu = std::max(_last_tabu, tabu);
+}
+
+[[nodiscard]] Coloration ProxiSolutionTabuCol::best_move(const long iteration,
+                                                        const int best_found) {
+    BestMoveSelector<Coloration> selector(Coloration{-1, -1});
+    for (const int vertex : _conflicting_vertices) {
+        // the delta of the moves of the bucket is the bucket number minus the number of
+        // neighbors of the vertex in its color
+        const int first_bucket{Graph::g->neighbors_offsets[vertex] + vertex};
+        const int end_bucket{Graph::g->neighbors_offsets[vertex + 1] + vertex + 1};
+        const int conflicts{_solution.conflicts_colors(_solution.color(vertex), vertex)};
+        int &lowest_bucket{_lowest_buckets[vertex]};
+        while (lowest_bucket < end_bucket and _buckets_first[lowest_bucket] == -1) {
+            ++lowest_bucket;
+        }
+        for (int bucket{lowest_bucket}; bucket < end_bucket; ++bucket) {
+            const int delta{bucket - first_bucket - conflicts};
+            if (delta > selector.best_key()) {
+                break;
+            }
+            // the tabu moves are allowed if they improve the best found penalty
+            const bool is_improving{_solution.penalty() + delta < best_found};
+            bool found{false};
+            for (int move{_buckets_first[bucket]}; move != -1; move = _moves_next[move]) {
+                if (not is_improving and _tabu[move] >= _tabu_offset + iteration) {
+                    continue;
+                }
+                selector.offer({vertex, move - vertex * _nb_colors}, delta);
+                found = true;
+            }
+            if (found) {
+                break;
+            }
+        }
+    }
+    return selector.move();
+}
+
+bool ProxiSolutionTabuCol::check_solution() const {
+    assert(_solution.check_solution());
+    for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
+        for (int color{0}; color < _nb_colors; ++color) {
+            assert((_moves_buckets[vertex * _nb_colors + color] != -1) ==
+                   (_target_colors[color] and color != _solution.color(vertex) and
+                    _solution.has_conflicts(vertex)));
+        }
+        assert((_conflicting_positions[vertex] != -1) == _solution.has_conflicts(vertex));
+    }
+    return true;
+}
+
+[[nodiscard]] int ProxiSolutionTabuCol::penalty() const {
+    return _solution.penalty();
+}
+
+[[nodiscard]] const Solution &ProxiSolutionTabuCol::solution() const {
+    return _solution;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Solution.h"
+
+/**
+ * @brief Proxi solution for TabuCol
+ *
+ * Keep the list of conflicting vertices, the gamma matrix (for each color, for each
+ * vertex, number of neighbors in the color) is the conflicts matrix of the solution.
+ * The moves of each
+ * conflicting vertex are sorted in buckets by the number of neighbors of the vertex in
+ * the color of the move, so a move of a vertex only updates two moves of each
+ * conflicting neighbor (or all the moves of the neighbors that become conflicting) and
+ * the best moves of a conflicting vertex are found in its first buckets instead of
+ * evaluating all the colors.
+ *
+ * The moves go to the non empty colors of the solution only, so the number of colors of
+ * the solution doesn't change.
+ *
+ */
+class ProxiSolutionTabuCol {
+
+    /** @brief the current solution*/
+    Solution _solution;
+    /** @brief Number of colors of the solution (number of columns of the matrices)*/
+    int _nb_colors{0};
+
+    /** @brief For each move (vertex * _nb_colors + color), iteration (plus the offset)
+     * until which the vertex can't take the color again*/
+    std::vector<long> _tabu{};
+    /** @brief Offset of the iterations in the tabu list, the list is cleared by moving
+     * the offset after its last iteration*/
+    long _tabu_offset{0};
+    /** @brief Last iteration (plus the offset) in the tabu list*/
+    long _last_tabu{0};
+    /** @brief For each color, true if the color is non empty (the moves can use it)*/
+    std::vector<bool> _target_colors{};
+
+    /** @brief List of conflicting vertices (unordered)*/
+    std::vector<int> _conflicting_vertices{};
+    /** @brief For each vertex, its position in the conflicting vertices (-1 if none)*/
+    std::vector<int> _conflicting_positions{};
+
+    /** @brief For each vertex, for each number of neighbors in the color of a move (from
+     * 0 to the degree of the vertex), first move of the bucket (-1 if empty), the
+     * buckets of vertex v start at neighbors_offsets[v] + v*/
+    std::vector<int> _buckets_first{};
+    /** @brief For each vertex, no bucket of the vertex before this one has a move*/
+    std::vector<int> _lowest_buckets{};
+    /** @brief For each move, its bucket (-1 if the move isn't possible or if the vertex
+     * has no conflicts)*/
+    std::vector<int> _moves_buckets{};
+    /** @brief For each move, previous move in its bucket (-1 for the first one)*/
+    std::vector<int> _moves_previous{};
+    /** @brief For each move, next move in its bucket (-1 for the last one)*/
+    std::vector<int> _moves_next{};
+
+    /**
+     * @brief Add or remove the vertex from the conflicting vertices according to its
+     * conflicts, with its moves
+     *
+     * @param vertex the vertex
+     */
+    void update_conflicting(const int vertex);
+
+    /**
+     * @brief Add the move of the vertex to the color in the bucket of its number of
+     * neighbors in the color
+     *
+     * @param vertex the vertex
+     * @param color the color
+     */
+    void insert_move(const int vertex, const int color);
+
+    /**
+     * @brief Remove the move of the vertex to the color from its bucket (if the move is
+     * possible)
+     *
+     * @param vertex the vertex
+     * @param color the color
+     */
+    void remove_move(const int vertex, const int color);
+
+    /**
+     * @brief Move the move of the vertex to the color to the bucket of its current
+     * number of neighbors in the color (if the move is possible)
+     *
+     * @param vertex the vertex
+     * @param color the color
+     */
+    void update_bucket(const int vertex, const int color);
+
+    /**
+     * @brief Init the tabu list and the moves from the solution (the buffers are
+     * reused)
+     *
+     */
+    void init_structures();
+
+  public:
+    ProxiSolutionTabuCol() = delete;
+    ProxiSolutionTabuCol(const Solution &solution);
+
+    /**
+     * @brief Restart the proxi solution from the solution, without reallocating its
+     * buffers
+     *
+     * @param solution the solution
+     */
+    void reset(const Solution &solution);
+
+    /**
+     * @brief Remove one color and create conflicts (see Solution), the moves are updated
+     *
+     */
+    void remove_one_color_and_create_conflicts();
+
+    /**
+     * @brief Move the vertex to the color and update the moves
+     *
+     * @param vertex the vertex
+     * @param color the new color (a non empty color)
+     * @return int the old color
+     */
+    int move(const int vertex, const int color);
+
+    /**
+     * @brief Remove all the moves from the tabu list (in constant time)
+     *
+     */
+    void clear_tabu();
+
+    /**
+     * @brief Forbid the vertex to take the color until the given iteration
+     *
+     * @param vertex the vertex
+     * @param color the color
+     * @param iteration last iteration of the tabu
+     */
+    void set_tabu(const int vertex, const int color, const long iteration);
+
+    /**
+     * @brief Return a random move among the moves with the lowest delta on the
+     * conflicts among the moves of the conflicting vertices that aren't tabu or that
+     * improve the best found penalty
+     *
+     * @param iteration current iteration
+     * @param best_found best found penalty
+     * @return Coloration the move, vertex -1 if every move is tabu
+     */
+    [[nodiscard]] Coloration best_move(const long iteration, const int best_found);
+
+    bool check_solution() const;
+
+    [[nodiscard]] int penalty() const;
+
+    [[nodiscard]] const Solution &solution() const;
+};
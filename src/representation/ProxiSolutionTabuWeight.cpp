@@ -0,0 +1,260 @@
+#include "ProxiSolutionTabuWeight.h"
+
+#include <cassert>
+#include <limits>
+
+#include "../utils/random_generator.h"
+
+ProxiSolutionTabuWeight::ProxiSolutionTabuWeight(const Solution &solution,
+                                                 const int penalty_coeff,
+                                                 const bool legal_moves)
+    : _solution(solution), _penalty_coeff(penalty_coeff), _legal_moves(legal_moves) {
+    init_structures();
+}
+
+void ProxiSolutionTabuWeight::reset(const Solution &solution,
+                                    const int penalty_coeff,
+                                    const bool legal_moves) {
+    _solution = solution;
+    _penalty_coeff = penalty_coeff;
+    _legal_moves = legal_moves;
+    init_structures();
+}
+
+void ProxiSolutionTabuWeight::init_structures() {
+    _nb_colors = _solution.nb_colors();
+    _deltas.assign(static_cast<size_t>(Graph::g->nb_vertices) * _nb_colors,
+                   std::numeric_limits<int>::max());
+    _best_deltas.resize(Graph::g->nb_vertices);
+    _nb_best_deltas.resize(Graph::g->nb_vertices);
+    _outdated.assign(Graph::g->nb_vertices, true);
+    _tabu.assign(Graph::g->nb_vertices, 0);
+    for (const int color : _solution.non_empty_colors()) {
+        int *deltas{&_deltas[color * Graph::g->nb_vertices]};
+        for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
+            deltas[vertex] = compute_delta(vertex, color);
+        }
+    }
+}
+
+[[nodiscard]] int ProxiSolutionTabuWeight::compute_delta(const int vertex,
+                                                         const int color) const {
+    if (color == _solution.color(vertex) or _solution.is_color_empty(color)) {
+        return std::numeric_limits<int>::max();
+    }
+    const int conflicts{_solution.conflicts_colors(color, vertex)};
+    if (_legal_moves and conflicts != 0) {
+        return std::numeric_limits<int>::max();
+    }
+    const int vertex_weight{Graph::g->weights[vertex]};
+    const int max_weight{_solution.max_weight(color)};
+    return (vertex_weight > max_weight ? vertex_weight - max_weight : 0) +
+           _penalty_coeff * conflicts;
+}
+
+void ProxiSolutionTabuWeight::set_delta(const int vertex,
+                                        const int color,
+                                        const int delta) {
+    int &old_delta{_deltas[color * Graph::g->nb_vertices + vertex]};
+    if (old_delta == delta) {
+        return;
+    }
+    const int previous_delta{old_delta};
+    old_delta = delta;
+    if (_outdated[vertex]) {
+        return;
+    }
+    const int best_delta{_best_deltas[vertex]};
+    int &nb_best{_nb_best_deltas[vertex]};
+    if (previous_delta == best_delta) {
+        --nb_best;
+    }
+    if (delta < best_delta) {
+        _best_deltas[vertex] = delta;
+        nb_best = 1;
+    } else if (delta == best_delta) {
+        ++nb_best;
+    } else if (nb_best == 0) {
+        // the only best color got worse, the other colors must be checked
+        _outdated[vertex] = true;
+    }
+}
+
+void ProxiSolutionTabuWeight::update_best_delta(const int vertex) {
+    // a new color is always possible
+    int best_delta{Graph::g->weights[vertex]};
+    int nb_best{1};
+    for (const int color : _solution.non_empty_colors()) {
+        const int delta{_deltas[color * Graph::g->nb_vertices + vertex]};
+        if (delta < best_delta) {
+            best_delta = delta;
+            nb_best = 1;
+        } else if (delta == best_delta) {
+            ++nb_best;
+        }
+    }
+    _best_deltas[vertex] = best_delta;
+    _nb_best_deltas[vertex] = nb_best;
+    _outdated[vertex] = false;
+}
+
+void ProxiSolutionTabuWeight::update_color(const int color,
+                                           const int vertex,
+                                           const bool all_vertices) {
+    if (all_vertices) {
+        for (int other_vertex{0}; other_vertex < Graph::g->nb_vertices;
+             ++other_vertex) {
+            set_delta(other_vertex, color, compute_delta(other_vertex, color));
+        }
+        return;
+    }
+    set_delta(vertex, color, compute_delta(vertex, color));
+    for (const int neighbor : Graph::g->neighbors(vertex)) {
+        set_delta(neighbor, color, compute_delta(neighbor, color));
+    }
+}
+
+void ProxiSolutionTabuWeight::move(const int vertex, const int color) {
+    const int old_color{_solution.color(vertex)};
+    const int old_max_weight{_solution.max_weight(old_color)};
+    const int new_max_weight{_solution.max_weight(color)};
+    _solution.delete_from_color(vertex);
+    const int new_color{_solution.add_to_color(vertex, color)};
+    if (new_color >= _nb_colors) {
+        _nb_colors = new_color + 1;
+        _deltas.resize(static_cast<size_t>(Graph::g->nb_vertices) * _nb_colors,
+                       std::numeric_limits<int>::max());
+    }
+    update_color(old_color,
+                 vertex,
+                 _solution.is_color_empty(old_color) or
+                     _solution.max_weight(old_color) != old_max_weight);
+    update_color(new_color,
+                 vertex,
+                 color == -1 or _solution.max_weight(new_color) != new_max_weight);
+}
+
+void ProxiSolutionTabuWeight::set_tabu(const int vertex, const long iteration) {
+    _tabu[vertex] = iteration;
+}
+
+[[nodiscard]] Coloration ProxiSolutionTabuWeight::best_move(const long iteration,
+                                                            const int best_score) {
+    _candidates.clear();
+    int best_evaluation{std::numeric_limits<int>::max()};
+    int nb_moves{0};
+    const int penalty{_solution.penalty()};
+    const int evaluation_solution{_solution.score_wvcp() + _penalty_coeff * penalty};
+    for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
+        if (_outdated[vertex]) {
+            update_best_delta(vertex);
+        }
+        const int conflicts{_solution.conflicts_colors(_solution.color(vertex), vertex)};
+        const int evaluation_vertex{evaluation_solution +
+                                    _solution.delta_wvcp_score_old_color(vertex) -
+                                    _penalty_coeff * conflicts};
+        int evaluation{evaluation_vertex + _best_deltas[vertex]};
+        if (evaluation > best_evaluation) {
+            continue;
+        }
+        Candidate candidate{vertex, _nb_best_deltas[vertex], false};
+        if (_tabu[vertex] > iteration) {
+            if (evaluation >= best_score) {
+                continue;
+            }
+            if (not _legal_moves) {
+                // the move must also remove all the conflicts
+                if (conflicts != penalty) {
+                    continue;
+                }
+                candidate.aspiration = true;
+                evaluation = std::numeric_limits<int>::max();
+                for (const int color : _solution.non_empty_colors()) {
+                    const int delta{_deltas[color * Graph::g->nb_vertices + vertex]};
+                    if (delta == std::numeric_limits<int>::max() or
+                        _solution.conflicts_colors(color, vertex) != 0) {
+                        continue;
+                    }
+                    if (evaluation_vertex + delta < evaluation) {
+                        evaluation = evaluation_vertex + delta;
+                        candidate.nb_moves = 1;
+                    } else if (evaluation_vertex + delta == evaluation) {
+                        ++candidate.nb_moves;
+                    }
+                }
+                const int new_color_evaluation{evaluation_vertex +
+                                               Graph::g->weights[vertex]};
+                if (new_color_evaluation < evaluation) {
+                    evaluation = new_color_evaluation;
+                    candidate.nb_moves = 1;
+                } else if (new_color_evaluation == evaluation) {
+                    ++candidate.nb_moves;
+                }
+                if (evaluation >= best_score or evaluation > best_evaluation) {
+                    continue;
+                }
+            }
+        }
+        if (evaluation < best_evaluation) {
+            best_evaluation = evaluation;
+            _candidates.clear();
+            nb_moves = 0;
+        }
+        _candidates.push_back(candidate);
+        nb_moves += candidate.nb_moves;
+    }
+    if (_candidates.empty()) {
+        return Coloration{-1, -1};
+    }
+
+    // same draw as rd::choice on the list of the best moves (sorted by vertex then by
+    // color in the order of the non empty colors and a new color at the end)
+    int index{rd::uniform(0, nb_moves - 1)};
+    size_t position{0};
+    while (index >= _candidates[position].nb_moves) {
+        index -= _candidates[position].nb_moves;
+        ++position;
+    }
+    const Candidate &candidate{_candidates[position]};
+    const int vertex{candidate.vertex};
+    const int evaluation_vertex{
+        evaluation_solution + _solution.delta_wvcp_score_old_color(vertex) -
+        _penalty_coeff * _solution.conflicts_colors(_solution.color(vertex), vertex)};
+    for (const int color : _solution.non_empty_colors()) {
+        const int delta{_deltas[color * Graph::g->nb_vertices + vertex]};
+        if (delta == std::numeric_limits<int>::max() or
+            evaluation_vertex + delta != best_evaluation or
+            (candidate.aspiration and _solution.conflicts_colors(color, vertex) != 0)) {
+            continue;
+        }
+        if (index == 0) {
+            return Coloration{vertex, color};
+        }
+        --index;
+    }
+    assert(index == 0 and
+           evaluation_vertex + Graph::g->weights[vertex] == best_evaluation);
+    return Coloration{vertex, -1};
+}
+
+bool ProxiSolutionTabuWeight::check_solution() const {
+    assert(_solution.check_solution());
+    for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
+        const int best_delta{_best_deltas[vertex]};
+        int nb_best{Graph::g->weights[vertex] == best_delta ? 1 : 0};
+        for (int color{0}; color < _nb_colors; ++color) {
+            const int delta{_deltas[color * Graph::g->nb_vertices + vertex]};
+            assert(delta == compute_delta(vertex, color));
+            assert(_outdated[vertex] or delta >= best_delta);
+            if (delta == best_delta) {
+                ++nb_best;
+            }
+        }
+        assert(_outdated[vertex] or _nb_best_deltas[vertex] == nb_best);
+    }
+    return true;
+}
+
+[[nodiscard]] const Solution &ProxiSolutionTabuWeight::solution() const {
+    return _solution;
+}
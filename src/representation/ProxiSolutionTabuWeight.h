@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Solution.h"
+
+/**
+ * @brief Proxi solution for tabu_weight and afisa_tabu
+ *
+ * The moves of a vertex go to the non empty colors other than its color or to a new
+ * color (-1). The evaluation of a move is the sum of :
+ *  - the score and the penalty (times the penalty coefficient) of the solution,
+ *  - the delta of the vertex leaving its color (score and conflicts),
+ *  - the delta of the vertex entering the new color (score and conflicts).
+ *
+ * The last part only depends on the vertex, the new color and its heaviest weight, it is
+ * kept in a table for each color and each vertex with, for each vertex, its lowest value.
+ * A move only updates the values of the neighbors of the vertex in its old and new
+ * colors, or the whole column of a color if its heaviest weight changes. The best moves
+ * are found in one pass on the vertices instead of evaluating all the colors of each
+ * vertex.
+ *
+ * The vertices in the tabu list can't move unless the move is better than the best
+ * score (and removes all the conflicts when the moves can create conflicts).
+ *
+ */
+class ProxiSolutionTabuWeight {
+
+    /** @brief Vertex whose moves are among the best moves*/
+    struct Candidate {
+        /** @brief the vertex*/
+        int vertex;
+        /** @brief number of best moves of the vertex*/
+        int nb_moves;
+        /** @brief true if the vertex is tabu and only its moves that remove all the
+         * conflicts and improve the best score are allowed*/
+        bool aspiration;
+    };
+
+    /** @brief the current solution*/
+    Solution _solution;
+    /** @brief Coefficient of the penalty in the evaluation of the moves*/
+    int _penalty_coeff;
+    /** @brief True if the moves can't create conflicts*/
+    bool _legal_moves;
+    /** @brief Number of colors of the solution (number of columns of the table)*/
+    int _nb_colors{0};
+
+    /** @brief For each color, for each vertex (color * nb_vertices + vertex), delta of
+     * the vertex entering the color (max int if the move isn't possible)*/
+    std::vector<int> _deltas{};
+    /** @brief For each vertex, lowest delta of the vertex entering a color (a new color
+     * included)*/
+    std::vector<int> _best_deltas{};
+    /** @brief For each vertex, number of colors with the lowest delta*/
+    std::vector<int> _nb_best_deltas{};
+    /** @brief For each vertex, true if its lowest delta must be computed again*/
+    std::vector<bool> _outdated{};
+    /** @brief For each vertex, the vertex is tabu while the iteration is lower*/
+    std::vector<long> _tabu{};
+
+    /** @brief Vertices with the best moves found by the last call to best_move*/
+    std::vector<Candidate> _candidates{};
+
+    /**
+     * @brief Return the delta of the vertex entering the color (without the delta of the
+     * vertex leaving its color)
+     *
+     * @param vertex the vertex
+     * @param color the color
+     * @return int the delta, max int if the move isn't possible
+     */
+    [[nodiscard]] int compute_delta(const int vertex, const int color) const;
+
+    /**
+     * @brief Change the delta of the vertex entering the color and its lowest delta
+     *
+     * @param vertex the vertex
+     * @param color the color
+     * @param delta the new delta
+     */
+    void set_delta(const int vertex, const int color, const int delta);
+
+    /**
+     * @brief Compute the lowest delta of the vertex and its number of colors
+     *
+     * @param vertex the vertex
+     */
+    void update_best_delta(const int vertex);
+
+    /**
+     * @brief Update the deltas of the color after a move of the vertex
+     *
+     * @param color the color
+     * @param vertex the moved vertex
+     * @param all_vertices true if the heaviest weight of the color changed, the deltas of
+     * all the vertices are computed again, otherwise only the vertex and its neighbors
+     */
+    void update_color(const int color, const int vertex, const bool all_vertices);
+
+    /**
+     * @brief Init the deltas and the tabu list from the solution (the buffers are
+     * reused)
+     *
+     */
+    void init_structures();
+
+  public:
+    ProxiSolutionTabuWeight() = delete;
+
+    /**
+     * @brief Construct the proxi solution
+     *
+     * @param solution the solution
+     * @param penalty_coeff coefficient of the penalty in the evaluation of the moves
+     * @param legal_moves true to forbid the moves to colors with conflicts
+     */
+    ProxiSolutionTabuWeight(const Solution &solution,
+                            const int penalty_coeff,
+                            const bool legal_moves);
+
+    /**
+     * @brief Restart the proxi solution from the solution, without reallocating its
+     * buffers
+     *
+     * @param solution the solution
+     * @param penalty_coeff coefficient of the penalty in the evaluation of the moves
+     * @param legal_moves true to forbid the moves to colors with conflicts
+     */
+    void reset(const Solution &solution, const int penalty_coeff, const bool legal_moves);
+
+    /**
+     * @brief Move the vertex to the color and update the deltas
+     *
+     * @param vertex the vertex
+     * @param color the new color (a non empty color or -1 for a new color)
+     */
+    void move(const int vertex, const int color);
+
+    /**
+     * @brief Forbid the moves of the vertex until the given iteration
+     *
+     * @param vertex the vertex
+     * @param iteration first iteration the vertex can move again
+     */
+    void set_tabu(const int vertex, const long iteration);
+
+    /**
+     * @brief Return a random move among the moves with the lowest evaluation, the moves
+     * of the tabu vertices are allowed if their score is lower than the best score (and
+     * if they remove all the conflicts when the moves aren't legal)
+     *
+     * @param iteration current iteration
+     * @param best_score best score found
+     * @return Coloration the move, vertex -1 if there is no possible move
+     */
+    [[nodiscard]] Coloration best_move(const long iteration, const int best_score);
+
+    bool check_solution() const;
+
+    [[nodiscard]] const Solution &solution() const;
+};
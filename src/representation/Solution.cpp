@@ -7,13 +7,19 @@
 #include "../utils/random_generator.h"
 #include "../utils/utils.h"
 
-int Solution::best_score_wvcp = std::numeric_limits<int>::max();
-int Solution::best_nb_colors = std::numeric_limits<int>::max();
-int Solution::max_nb_colors = 0;
+std::atomic<int> Solution::best_score_wvcp{std::numeric_limits<int>::max()};
+std::atomic<int> Solution::best_nb_colors{std::numeric_limits<int>::max()};
+std::atomic<int> Solution::max_nb_colors{0};
 
 const std::string Solution::header_csv = "nb_colors,penalty,score,solution";
 
-Solution::Solution() : _colors(Graph::g->nb_vertices, -1) {
+Solution::Solution()
+    : _colors(Graph::g->nb_vertices, -1),
+      _positions(Graph::g->nb_vertices, -1),
+      _levels_words((static_cast<int>(Graph::g->distinct_weights.size()) + 63) / 64),
+      _conflicts_row_size((Graph::g->nb_vertices + 15) / 16 * 16) {
+    // the buffer grows geometrically when the colors are created
+    _conflicts_colors.reserve(static_cast<size_t>(max_nb_colors) * _conflicts_row_size);
 }
 
 int Solution::add_to_color(const int vertex, int color) {
@@ -21,16 +27,23 @@ int Solution::add_to_color(const int vertex, int color) {
     assert(_colors[vertex] == -1);
     assert(color == -1 or not _colors_vertices[color].empty());
 
+    bool created_color{false};
+    int color_position{-1};
     // if the color is -1 (ask for a new color group)
     if (color == -1) {
+        color_position = static_cast<int>(_non_empty_colors.size());
         if (_empty_colors.empty()) {
             // create a new color if needed
-            _conflicts_colors.emplace_back(Graph::g->nb_vertices, 0);
+            _conflicts_colors.resize(_conflicts_colors.size() + _conflicts_row_size, 0);
             _colors_vertices.emplace_back();
+            _colors_levels.emplace_back(Graph::g->distinct_weights.size(), 0);
+            _levels_masks.resize(_levels_masks.size() + _levels_words, 0);
             _heaviest_weight.emplace_back(0);
+            _heaviest_level.emplace_back(-1);
             _non_empty_colors.push_back(_nb_colors);
             color = _nb_colors;
             ++_nb_colors;
+            created_color = true;
         } else {
             // reuse an old color currently empty
             color = _empty_colors.back();
@@ -38,15 +51,26 @@ int Solution::add_to_color(const int vertex, int color) {
             _non_empty_colors.push_back(color);
         }
     }
+    if (_trail.recording) {
+        record({true,
+                vertex,
+                color,
+                _heaviest_level[color],
+                -1,
+                created_color,
+                color_position});
+    }
+
+    int *conflicts{&_conflicts_colors[color * _conflicts_row_size]};
 
     // Update penalty
-    _penalty += _conflicts_colors[color][vertex];
+    _penalty += conflicts[vertex];
 
     // update conflicts for neighbors
-    for (const auto &neighbor : Graph::g->neighborhood[vertex]) {
-        ++_conflicts_colors[color][neighbor];
+    for (const auto &neighbor : Graph::g->neighbors(vertex)) {
+        ++conflicts[neighbor];
         // if there is a new edge in conflict
-        if (color == _colors[neighbor] and _conflicts_colors[color][neighbor] == 1) {
+        if (color == _colors[neighbor] and conflicts[neighbor] == 1) {
             ++_nb_conflicting_vertices;
         }
     }
@@ -55,7 +79,10 @@ int Solution::add_to_color(const int vertex, int color) {
     const int vertex_weight = Graph::g->weights[vertex];
 
     // update vertices for the color class
-    _colors_vertices[color].insert(vertex);
+    const int level{Graph::g->weight_levels[vertex]};
+    _positions[vertex] = static_cast<int>(_colors_vertices[color].size());
+    _colors_vertices[color].push_back(vertex);
+    increment_level(color, level);
 
     // update colors
     _colors[vertex] = color;
@@ -64,6 +91,7 @@ int Solution::add_to_color(const int vertex, int color) {
     if (vertex_weight > old_max_weight) {
         _score_wvcp += (vertex_weight - old_max_weight);
         _heaviest_weight[color] = vertex_weight;
+        _heaviest_level[color] = level;
     }
 
     return color;
@@ -73,16 +101,20 @@ int Solution::delete_from_color(const int vertex) {
     const int color = _colors[vertex];
     assert(color != -1);
     assert(vertex < Graph::g->nb_vertices);
+    const int heaviest_level{_heaviest_level[color]};
+    const int position{_positions[vertex]};
+
+    int *conflicts{&_conflicts_colors[color * _conflicts_row_size]};
 
     // Update conflict score
-    _penalty -= _conflicts_colors[color][vertex];
+    _penalty -= conflicts[vertex];
 
     // update conflicts for neighbors
-    for (const int neighbor : Graph::g->neighborhood[vertex]) {
-        if (color == _colors[neighbor] and _conflicts_colors[color][neighbor] == 1) {
+    for (const int neighbor : Graph::g->neighbors(vertex)) {
+        if (color == _colors[neighbor] and conflicts[neighbor] == 1) {
             --_nb_conflicting_vertices;
         }
-        --_conflicts_colors[color][neighbor];
+        --conflicts[neighbor];
     }
 
     // update wvcp score
@@ -91,30 +123,166 @@ int Solution::delete_from_color(const int vertex) {
     _score_wvcp += delta_score;
 
     if (delta_score != 0) {
-        _heaviest_weight[color] = second_max_weight(color);
+        set_heaviest_level(color, second_max_level(color));
     }
 
-    // remove from color group
-    _colors_vertices[color].erase(vertex);
+    // remove from color group (the last vertex of the color takes its place)
+    std::vector<int> &vertices{_colors_vertices[color]};
+    const int last_vertex{vertices.back()};
+    vertices[position] = last_vertex;
+    _positions[last_vertex] = position;
+    vertices.pop_back();
+    decrement_level(color, Graph::g->weight_levels[vertex]);
 
     _colors[vertex] = -1;
 
     // delete color if needed
+    int color_position{-1};
     if (_colors_vertices[color].empty()) {
         const auto it =
             std::find(_non_empty_colors.begin(), _non_empty_colors.end(), color);
-        _non_empty_colors[std::distance(_non_empty_colors.begin(), it)] =
-            _non_empty_colors.back();
+        color_position = static_cast<int>(std::distance(_non_empty_colors.begin(), it));
+        _non_empty_colors[color_position] = _non_empty_colors.back();
         _non_empty_colors.pop_back();
         _empty_colors.push_back(color);
     }
+    if (_trail.recording) {
+        record({false, vertex, color, heaviest_level, position, false, color_position});
+    }
 
     return color;
 }
 
+void Solution::set_checkpoint() {
+    _trail.recording = true;
+    _trail.changes.clear();
+    _trail.cost = 0;
+    _trail.max_cost = static_cast<long>(_nb_colors + 1) * Graph::g->nb_vertices;
+    _trail.nb_colors = _nb_colors;
+    _trail.first_free_vertex = _first_free_vertex;
+    _trail.score_wvcp = _score_wvcp;
+    _trail.penalty = _penalty;
+    _trail.nb_conflicting_vertices = _nb_conflicting_vertices;
+}
+
+[[nodiscard]] bool Solution::rollback() {
+    if (not _trail.recording) {
+        return false;
+    }
+    for (auto it{_trail.changes.rbegin()}; it != _trail.changes.rend(); ++it) {
+        undo(*it);
+    }
+    _trail.changes.clear();
+    _trail.cost = 0;
+    _first_free_vertex = _trail.first_free_vertex;
+    _score_wvcp = _trail.score_wvcp;
+    _penalty = _trail.penalty;
+    _nb_conflicting_vertices = _trail.nb_conflicting_vertices;
+    return true;
+}
+
+void Solution::record(const SolutionChange &change) {
+    if (change.color < _trail.nb_colors) {
+        _trail.cost += static_cast<long>(Graph::g->neighbors(change.vertex).size()) + 1;
+    } else {
+        ++_trail.cost;
+    }
+    if (_trail.cost > _trail.max_cost) {
+        // a copy of the solution will be faster
+        _trail.recording = false;
+        _trail.changes.clear();
+        return;
+    }
+    _trail.changes.push_back(change);
+}
+
+void Solution::undo(const SolutionChange &change) {
+    const int vertex{change.vertex};
+    const int color{change.color};
+    // the content of the colors created after the checkpoint is deleted with the colors
+    const bool old_color{color < _trail.nb_colors};
+    if (change.added) {
+        // uncolor the vertex (the scores are restored at the end of the rollback)
+        if (old_color) {
+            int *conflicts{&_conflicts_colors[color * _conflicts_row_size]};
+            for (const int neighbor : Graph::g->neighbors(vertex)) {
+                --conflicts[neighbor];
+            }
+            // the vertex is the last one of the color as the next changes are undone
+            _colors_vertices[color].pop_back();
+            decrement_level(color, Graph::g->weight_levels[vertex]);
+            set_heaviest_level(color, change.heaviest_level);
+        }
+        _colors[vertex] = -1;
+        if (change.created_color) {
+            _conflicts_colors.resize(_conflicts_colors.size() - _conflicts_row_size);
+            _colors_vertices.pop_back();
+            _colors_levels.pop_back();
+            _levels_masks.resize(_levels_masks.size() - _levels_words);
+            _heaviest_weight.pop_back();
+            _heaviest_level.pop_back();
+            _non_empty_colors.pop_back();
+            --_nb_colors;
+        } else if (change.color_position != -1) {
+            _non_empty_colors.pop_back();
+            _empty_colors.push_back(color);
+        }
+        return;
+    }
+    // color the vertex again
+    if (change.color_position != -1) {
+        _empty_colors.pop_back();
+        if (change.color_position == static_cast<int>(_non_empty_colors.size())) {
+            _non_empty_colors.push_back(color);
+        } else {
+            _non_empty_colors.push_back(_non_empty_colors[change.color_position]);
+            _non_empty_colors[change.color_position] = color;
+        }
+    }
+    if (old_color) {
+        int *conflicts{&_conflicts_colors[color * _conflicts_row_size]};
+        for (const int neighbor : Graph::g->neighbors(vertex)) {
+            ++conflicts[neighbor];
+        }
+        // put back the vertex at its position
+        std::vector<int> &vertices{_colors_vertices[color]};
+        const int position{change.vertex_position};
+        if (position == static_cast<int>(vertices.size())) {
+            vertices.push_back(vertex);
+        } else {
+            const int moved_vertex{vertices[position]};
+            _positions[moved_vertex] = static_cast<int>(vertices.size());
+            vertices.push_back(moved_vertex);
+            vertices[position] = vertex;
+        }
+        _positions[vertex] = position;
+        increment_level(color, Graph::g->weight_levels[vertex]);
+        set_heaviest_level(color, change.heaviest_level);
+    }
+    _colors[vertex] = color;
+}
+
+void Solution::increment_level(const int color, const int level) {
+    if (++_colors_levels[color][level] == 1) {
+        _levels_masks[color * _levels_words + level / 64] |= uint64_t{1} << (level % 64);
+    }
+}
+
+void Solution::decrement_level(const int color, const int level) {
+    if (--_colors_levels[color][level] == 0) {
+        _levels_masks[color * _levels_words + level / 64] &=
+            ~(uint64_t{1} << (level % 64));
+    }
+}
+
+void Solution::set_heaviest_level(const int color, const int level) {
+    _heaviest_level[color] = level;
+    _heaviest_weight[color] = level == -1 ? 0 : Graph::g->distinct_weights[level];
+}
+
 [[nodiscard]] int Solution::first_available_color(const int &vertex) {
     for (const int &color : _non_empty_colors) {
-        if (_conflicts_colors[color][vertex] == 0) {
+        if (_conflicts_colors[color * _conflicts_row_size + vertex] == 0) {
             return color;
         }
     }
@@ -124,7 +292,7 @@ int Solution::delete_from_color(const int vertex) {
 [[nodiscard]] std::vector<int> Solution::available_colors(const int &vertex) const {
     std::vector<int> available_colors;
     for (const auto &color : _non_empty_colors) {
-        if (_conflicts_colors[color][vertex] == 0) {
+        if (_conflicts_colors[color * _conflicts_row_size + vertex] == 0) {
             available_colors.emplace_back(color);
         }
     }
@@ -139,7 +307,7 @@ void Solution::clean_conflicts() {
         int nb_max_conflicts = 0;
         std::vector<int> max_vertex;
         for (int vertex{0}; vertex < Graph::g->nb_vertices; ++vertex) {
-            const int nb_conflicts = _conflicts_colors[_colors[vertex]][vertex];
+            const int nb_conflicts = conflicts_colors(_colors[vertex], vertex);
             if (nb_conflicts == 0) {
                 continue;
             }
@@ -170,9 +338,10 @@ void Solution::remove_one_color_and_create_conflicts() {
             if (color1 == color2) {
                 continue;
             }
+            const int *conflicts{&_conflicts_colors[color2 * _conflicts_row_size]};
             int sum_conflicts{0};
             for (const int vertex : _colors_vertices[color1]) {
-                sum_conflicts += _conflicts_colors[color2][vertex];
+                sum_conflicts += conflicts[vertex];
             }
             if (sum_conflicts < best_sum_conflicts) {
                 best_color1 = color1;
@@ -228,9 +397,9 @@ void Solution::remove_one_color_and_create_conflicts() {
 
 [[nodiscard]] int Solution::delta_conflicts(const int vertex, const int color) const {
     if (color == -1) {
-        return -_conflicts_colors[_colors[vertex]][vertex];
+        return -conflicts_colors(_colors[vertex], vertex);
     }
-    return _conflicts_colors[color][vertex] - _conflicts_colors[_colors[vertex]][vertex];
+    return conflicts_colors(color, vertex) - conflicts_colors(_colors[vertex], vertex);
 }
 
 void Solution::increment_first_free_vertex() {
@@ -264,7 +433,7 @@ bool Solution::check_solution() const {
     int score = 0;
 
     for (int vertex = 0; vertex < Graph::g->nb_vertices; ++vertex) {
-        if (Graph::g->neighborhood[vertex].empty() or _colors[vertex] == -1)
+        if (Graph::g->neighbors(vertex).empty() or _colors[vertex] == -1)
             continue;
         const int color = _colors[vertex];
 
@@ -281,6 +450,14 @@ bool Solution::check_solution() const {
         score += max_colors_weights[color];
     }
 
+    for (int color = 0; color < _nb_colors; ++color) {
+        for (int level = 0; level < static_cast<int>(_colors_levels[color].size());
+             ++level) {
+            assert(((_levels_masks[color * _levels_words + level / 64] >> (level % 64)) &
+                    1) == (_colors_levels[color][level] > 0 ? 1 : 0));
+        }
+    }
+
     for (const int &color : _empty_colors) {
         (void)color;
         assert(max_colors_weights[color] == 0);
@@ -300,17 +477,37 @@ bool Solution::check_solution() const {
 }
 
 [[nodiscard]] int Solution::second_max_weight(const int &color) const {
-    if (color == -1 or color >= _nb_colors or _colors_vertices[color].size() <= 1) {
+    if (color == -1 or color >= _nb_colors) {
         return 0;
     }
-    return Graph::g->weights[*(++_colors_vertices[color].begin())];
+    const int level{second_max_level(color)};
+    return level == -1 ? 0 : Graph::g->distinct_weights[level];
+}
+
+[[nodiscard]] int Solution::second_max_level(const int &color) const {
+    if (_colors_vertices[color].size() <= 1) {
+        return -1;
+    }
+    const int level{_heaviest_level[color]};
+    if (_colors_levels[color][level] > 1) {
+        return level;
+    }
+    // first non empty level after the heaviest one (there is at least one lighter
+    // vertex in the color)
+    const uint64_t *masks{&_levels_masks[color * _levels_words]};
+    int word{level / 64};
+    uint64_t mask{masks[word] & (~uint64_t{1} << (level % 64))};
+    while (mask == 0) {
+        mask = masks[++word];
+    }
+    return word * 64 + __builtin_ctzll(mask);
 }
 
 [[nodiscard]] bool Solution::has_conflicts(const int vertex) const {
     if (_colors[vertex] == -1) {
         return 0;
     }
-    return _conflicts_colors[_colors[vertex]][vertex] != 0;
+    return conflicts_colors(_colors[vertex], vertex) != 0;
 }
 
 [[nodiscard]] bool Solution::is_color_empty(const int color) const {
@@ -346,10 +543,11 @@ bool Solution::check_solution() const {
 }
 
 [[nodiscard]] int Solution::conflicts_colors(const int &color, const int &vertex) const {
-    return _conflicts_colors[color][vertex];
+    return _conflicts_colors[color * _conflicts_row_size + vertex];
 }
 
-[[nodiscard]] const std::set<int> &Solution::colors_vertices(const int &color) const {
+[[nodiscard]] const std::vector<int> &
+Solution::colors_vertices(const int &color) const {
     return _colors_vertices[color];
 }
 
@@ -382,12 +580,14 @@ Solution::nb_vertices_per_color(const int nb_colors_max) const {
         for (const auto &vertex : vertices) {
             weights[color].emplace_back(Graph::g->weights[vertex]);
         }
+        std::sort(weights[color].begin(), weights[color].end(), std::greater<int>());
     }
     return weights;
 }
 
-[[nodiscard]] const std::vector<std::vector<int>> &Solution::conflicts_colors() const {
-    return _conflicts_colors;
+[[nodiscard]] Span<const int> Solution::conflicts_colors(const int color) const {
+    const int *row{&_conflicts_colors[color * _conflicts_row_size]};
+    return {row, row + Graph::g->nb_vertices};
 }
 
 int Solution::nb_conflicting_vertices() const {
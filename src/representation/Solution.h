@@ -1,37 +1,118 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
-#include <set>
 #include <tuple>
 
 #include "Graph.h"
 #include "Parameters.h"
 
+/**
+ * @brief Change made on a solution (vertex colored or uncolored), recorded to undo it
+ *
+ */
+struct SolutionChange {
+    /** @brief True if the vertex has been colored, false if it has been uncolored*/
+    bool added;
+    /** @brief The vertex*/
+    int vertex;
+    /** @brief The color of the vertex*/
+    int color;
+    /** @brief Weight level of the heaviest vertices of the color before the change*/
+    int heaviest_level;
+    /** @brief Position of the vertex in the vertices of the color before it has been
+     * uncolored*/
+    int vertex_position;
+    /** @brief True if the color has been created to color the vertex*/
+    bool created_color;
+    /** @brief Position of the color in the non empty colors if the color has been
+     * emptied or reused, -1 otherwise*/
+    int color_position;
+};
+
+/**
+ * @brief Undo log of a solution. The log is not copied with the solution : the copy is
+ * not recorded and a solution stops recording when another solution is assigned to it.
+ *
+ */
+struct SolutionTrail {
+    /** @brief True while the changes are recorded*/
+    bool recording{false};
+    /** @brief Changes since the checkpoint*/
+    std::vector<SolutionChange> changes{};
+    /** @brief Cost of the undo of the changes (about the number of updated values)*/
+    long cost{0};
+    /** @brief Maximal cost of the undo, the recording stops when an undo would cost
+     * more than a copy of the solution*/
+    long max_cost{0};
+    /** @brief Number of colors at the checkpoint, the colors created later are deleted
+     * by the rollback so their content isn't undone*/
+    int nb_colors{0};
+    /** @brief Next vertex to color in the MCTS tree at the checkpoint*/
+    int first_free_vertex{0};
+    /** @brief WVCP score at the checkpoint*/
+    int score_wvcp{0};
+    /** @brief Number of conflicts at the checkpoint*/
+    int penalty{0};
+    /** @brief Number of conflicting vertices at the checkpoint*/
+    int nb_conflicting_vertices{0};
+
+    SolutionTrail() = default;
+
+    SolutionTrail(const SolutionTrail &) {
+    }
+
+    SolutionTrail &operator=(const SolutionTrail &) {
+        recording = false;
+        changes.clear();
+        return *this;
+    }
+
+    ~SolutionTrail() = default;
+};
+
 /**
  * @brief Representation of a solution for Weighted Vertex Coloring Problem
  *
  */
 class Solution {
   public:
-    /** @brief WVCP best found score*/
-    static int best_score_wvcp;
+    /** @brief WVCP best found score (shared by the threads of the search)*/
+    static std::atomic<int> best_score_wvcp;
     /** @brief Minimal nb of color found (you have to update it)*/
-    static int best_nb_colors;
+    static std::atomic<int> best_nb_colors;
     /** @brief Max number of color for fixed nb_colors methods (you have to update it) */
-    static int max_nb_colors;
+    static std::atomic<int> max_nb_colors;
     /** @brief Header csv*/
     const static std::string header_csv;
 
   private:
     /** @brief For each vertex, its color*/
     std::vector<int> _colors{};
-    /** @brief For each color, set of the vertices colored with the color*/
-    std::vector<std::set<int>> _colors_vertices{};
+    /** @brief For each color, the vertices colored with the color (unordered)*/
+    std::vector<std::vector<int>> _colors_vertices{};
+    /** @brief For each vertex, its position in the vertices of its color*/
+    std::vector<int> _positions{};
+    /** @brief For each color, for each weight level (see Graph::weight_levels), number
+     * of vertices of the level in the color*/
+    std::vector<std::vector<int>> _colors_levels{};
+    /** @brief For each color, bits of the non empty weight levels of the color (bit
+     * level % 64 of the word color * _levels_words + level / 64)*/
+    std::vector<uint64_t> _levels_masks{};
+    /** @brief Number of words of the bits of the levels of a color*/
+    int _levels_words{0};
     /** @brief For each color, the heaviest weight*/
     std::vector<int> _heaviest_weight{};
+    /** @brief For each color, the weight level of the heaviest vertices (-1 if empty)*/
+    std::vector<int> _heaviest_level{};
 
-    /** @brief For each color, for each vertex, number of neighbors in the color*/
-    std::vector<std::vector<int>> _conflicts_colors{};
+    /** @brief For each color, for each vertex, number of neighbors in the color, the
+     * rows of the colors follow each other in one buffer (color * _conflicts_row_size +
+     * vertex)*/
+    std::vector<int, AlignedAllocator<int>> _conflicts_colors{};
+    /** @brief Size of a row of _conflicts_colors, the number of vertices rounded up to a
+     * cache line so each row is aligned*/
+    int _conflicts_row_size{0};
 
     /** @brief number of opened colors (not automaticaly all used)*/
     int _nb_colors{0};
@@ -51,6 +132,57 @@ class Solution {
     /** @brief number of conflicting vertices*/
     int _nb_conflicting_vertices{0};
 
+    /** @brief Changes since the last checkpoint (if recording)*/
+    SolutionTrail _trail{};
+
+    /**
+     * @brief Record a change of the solution if the trail is recording, stop the
+     * recording if the undo becomes more expensive than a copy of the solution
+     *
+     * @param change the change
+     */
+    void record(const SolutionChange &change);
+
+    /**
+     * @brief Undo a recorded change (the changes must be undone from the last one)
+     *
+     * @param change the change
+     */
+    void undo(const SolutionChange &change);
+
+    /**
+     * @brief Add a vertex of the weight level to the counts of the color
+     *
+     * @param color the color
+     * @param level the weight level
+     */
+    void increment_level(const int color, const int level);
+
+    /**
+     * @brief Remove a vertex of the weight level from the counts of the color
+     *
+     * @param color the color
+     * @param level the weight level
+     */
+    void decrement_level(const int color, const int level);
+
+    /**
+     * @brief Return the weight level of the second heaviest vertex of the color (next
+     * non empty level in the bits of the levels of the color)
+     *
+     * @param color the color
+     * @return int the level, -1 if the color has less than two vertices
+     */
+    [[nodiscard]] int second_max_level(const int &color) const;
+
+    /**
+     * @brief Set the weight level and the weight of the heaviest vertices of the color
+     *
+     * @param color the color
+     * @param level the level (-1 for an empty color)
+     */
+    void set_heaviest_level(const int color, const int level);
+
   public:
     /**
      * @brief Construct a new Solution object
@@ -84,6 +216,24 @@ class Solution {
      */
     int delete_from_color(const int vertex);
 
+    /**
+     * @brief Start recording the changes of the solution so it can go back to its
+     * current state with rollback, in a time proportional to the changes. The recording
+     * stops if the changes become more expensive to undo than a copy of the solution or
+     * if another solution is assigned to the solution.
+     *
+     */
+    void set_checkpoint();
+
+    /**
+     * @brief Undo the changes made since the checkpoint and keep recording
+     *
+     * @return true the solution is back to its state at the checkpoint
+     * @return false the changes weren't recorded, the solution must be restored by
+     * another way
+     */
+    [[nodiscard]] bool rollback();
+
     /**
      * @brief Give the first available color for the given vertex,
      * -1 if no color available
@@ -237,9 +387,9 @@ class Solution {
      * @brief Return vertices in given color
      *
      * @param color given color
-     * @return std::set<int> vertices in the color
+     * @return const std::vector<int>& vertices in the color (unordered)
      */
-    [[nodiscard]] const std::set<int> &colors_vertices(const int &color) const;
+    [[nodiscard]] const std::vector<int> &colors_vertices(const int &color) const;
 
     /**
      * @brief Return non empty colors
@@ -277,7 +427,13 @@ class Solution {
      */
     [[nodiscard]] std::vector<std::vector<int>> weights() const;
 
-    [[nodiscard]] const std::vector<std::vector<int>> &conflicts_colors() const;
+    /**
+     * @brief Get the number of neighbors in the color of each vertex
+     *
+     * @param color the color
+     * @return Span<const int> for each vertex, its number of neighbors in the color
+     */
+    [[nodiscard]] Span<const int> conflicts_colors(const int color) const;
 
     int nb_conflicting_vertices() const;
 };
@@ -0,0 +1,66 @@
+#include "TranspositionTable.h"
+
+#include <cstddef>
+
+namespace {
+
+/** @brief Flag of the used entries in the data*/
+constexpr uint64_t used_flag{uint64_t{1} << 32};
+
+/**
+ * @brief Return the smallest power of 2 greater or equal to the size (0 for 0)
+ *
+ * @param size the size
+ * @return size_t the power of 2
+ */
+size_t power_of_2(const long size) {
+    if (size <= 0) {
+        return 0;
+    }
+    size_t power{1};
+    while (power < static_cast<size_t>(size)) {
+        power <<= 1;
+    }
+    return power;
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(const long size)
+    : _entries(power_of_2(size)), _mask(_entries.empty() ? 0 : _entries.size() - 1) {
+}
+
+[[nodiscard]] uint64_t TranspositionTable::key(const int vertex, const int first_vertex) {
+    // splitmix64 finalizer, gives the random keys of the Zobrist hashing without
+    // storing a table of nb_vertices * nb_vertices keys
+    uint64_t z{((static_cast<uint64_t>(vertex) << 32) |
+                static_cast<uint32_t>(first_vertex)) +
+               0x9e3779b97f4a7c15};
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+[[nodiscard]] bool TranspositionTable::find(const uint64_t hash, int &score) const {
+    if (_entries.empty()) {
+        return false;
+    }
+    const Entry &entry{_entries[hash & _mask]};
+    const uint64_t data{entry.data.load(std::memory_order_relaxed)};
+    const uint64_t check{entry.check.load(std::memory_order_relaxed)};
+    if ((data & used_flag) == 0 or (check ^ data) != hash) {
+        return false;
+    }
+    score = static_cast<int>(static_cast<uint32_t>(data));
+    return true;
+}
+
+void TranspositionTable::store(const uint64_t hash, const int score) {
+    if (_entries.empty()) {
+        return;
+    }
+    Entry &entry{_entries[hash & _mask]};
+    const uint64_t data{used_flag | static_cast<uint32_t>(score)};
+    entry.check.store(hash ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
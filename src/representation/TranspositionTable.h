@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Bounded table of the scores of the simulations of the partial colorations
+ *
+ * A partial coloration of the first vertices is identified by a Zobrist hash of its
+ * partition : each vertex contributes the key of the pair (vertex, first vertex of its
+ * color), so the hash doesn't depend on the labels of the colors and can be updated at
+ * each move. The table is shared by the threads without lock : an entry stores its data
+ * and its hash xored with its data, an entry written by two threads at the same time
+ * doesn't match any hash. A new entry replaces the previous one of its slot.
+ *
+ */
+class TranspositionTable {
+
+    /** @brief Entry of the table*/
+    struct Entry {
+        /** @brief Hash of the partial coloration xored with the data*/
+        std::atomic<uint64_t> check{0};
+        /** @brief Score of the simulation (low bits) and used flag (high bits)*/
+        std::atomic<uint64_t> data{0};
+    };
+
+    /** @brief Entries of the table (size is a power of 2)*/
+    std::vector<Entry> _entries;
+    /** @brief Mask of the index of the entry of a hash*/
+    const uint64_t _mask;
+
+  public:
+    /**
+     * @brief Construct the table
+     *
+     * @param size number of entries (rounded up to a power of 2), 0 to disable the table
+     */
+    explicit TranspositionTable(const long size);
+
+    TranspositionTable(const TranspositionTable &other) = delete;
+    TranspositionTable &operator=(const TranspositionTable &other) = delete;
+
+    /**
+     * @brief Return the Zobrist key of a vertex in a color
+     *
+     * @param vertex the vertex
+     * @param first_vertex first vertex of the color of the vertex (the vertex itself for
+     * a new color)
+     * @return uint64_t key to xor to the hash of the partial coloration
+     */
+    [[nodiscard]] static uint64_t key(const int vertex, const int first_vertex);
+
+    /**
+     * @brief Search the score of the simulation of a partial coloration
+     *
+     * @param hash hash of the partial coloration
+     * @param score score of the simulation if found
+     * @return true the partial coloration has been simulated
+     * @return false the partial coloration isn't in the table (or no table)
+     */
+    [[nodiscard]] bool find(const uint64_t hash, int &score) const;
+
+    /**
+     * @brief Store the score of the simulation of a partial coloration (if there is a
+     * table)
+     *
+     * @param hash hash of the partial coloration
+     * @param score score of the simulation
+     */
+    void store(const uint64_t hash, const int score);
+};
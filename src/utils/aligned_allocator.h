@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+/**
+ * @brief Allocator returning memory aligned on the given number of bytes (a cache line
+ * by default), used for the flat bitsets and matrices of the search
+ *
+ * @tparam T value type
+ * @tparam Alignment alignment in bytes
+ */
+template <typename T, std::size_t Alignment = 64> struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U> struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    explicit AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {
+    }
+
+    [[nodiscard]] T *allocate(const std::size_t n) {
+        return static_cast<T *>(
+            ::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T *pointer, const std::size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t{Alignment});
+    }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment> &,
+                const AlignedAllocator<U, Alignment> &) noexcept {
+    return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment> &,
+                const AlignedAllocator<U, Alignment> &) noexcept {
+    return false;
+}
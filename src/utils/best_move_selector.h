@@ -0,0 +1,83 @@
+#pragma once
+
+#include <limits>
+
+#include "random_generator.h"
+
+/**
+ * @brief Random choice among the moves of lowest key, in one pass and without storing
+ * the moves
+ *
+ * Reservoir sampling : the n-th move of the lowest key replaces the chosen move with a
+ * probability of 1/n, so each move of the lowest key is chosen with the same
+ * probability.
+ *
+ * @tparam Move type of the moves
+ */
+template <typename Move> class BestMoveSelector {
+    /** @brief Chosen move*/
+    Move _move;
+    /** @brief Key of the chosen move*/
+    int _best_key{std::numeric_limits<int>::max()};
+    /** @brief Number of moves with the key of the chosen move*/
+    int _nb_best_moves{0};
+
+  public:
+    /**
+     * @brief Construct a new selector
+     *
+     * @param no_move move returned if no move is offered
+     */
+    explicit BestMoveSelector(const Move &no_move) : _move(no_move) {
+    }
+
+    /**
+     * @brief Choose the move as the only move with the new best key
+     *
+     * @param move the move
+     * @param key key of the move
+     */
+    void restart(const Move &move, const int key) {
+        _move = move;
+        _best_key = key;
+        _nb_best_moves = 1;
+    }
+
+    /**
+     * @brief Add a move with the key of the chosen move
+     *
+     * @param move the move
+     */
+    void add_tie(const Move &move) {
+        ++_nb_best_moves;
+        if (rd::uniform(0, _nb_best_moves - 1) == 0) {
+            _move = move;
+        }
+    }
+
+    /**
+     * @brief Offer a move, kept if its key is the lowest (lower key is better)
+     *
+     * @param move the move
+     * @param key key of the move
+     */
+    void offer(const Move &move, const int key) {
+        if (key < _best_key) {
+            restart(move, key);
+        } else if (key == _best_key) {
+            add_tie(move);
+        }
+    }
+
+    [[nodiscard]] bool empty() const {
+        return _nb_best_moves == 0;
+    }
+
+    [[nodiscard]] int best_key() const {
+        return _best_key;
+    }
+
+    [[nodiscard]] const Move &move() const {
+        return _move;
+    }
+};
@@ -0,0 +1,41 @@
+#include "deadline.h"
+
+#include "../representation/Parameters.h"
+
+namespace {
+
+/** @brief Maximal number of calls between two reads of the clock*/
+constexpr long max_period{4096};
+
+} // namespace
+
+Deadline::Deadline(const std::chrono::high_resolution_clock::time_point &limit)
+    : _limit(limit) {
+}
+
+void Deadline::reset(const std::chrono::high_resolution_clock::time_point &limit) {
+    _limit = limit;
+    _countdown = 1;
+    _reached = false;
+}
+
+[[nodiscard]] bool Deadline::reached() {
+    if (_reached) {
+        return true;
+    }
+    if (--_countdown > 0) {
+        return false;
+    }
+    const auto now{std::chrono::high_resolution_clock::now()};
+    // aim at one read of the clock per millisecond
+    const auto since_last_check{now - _last_check};
+    if (since_last_check < std::chrono::microseconds(500) and _period < max_period) {
+        _period *= 2;
+    } else if (since_last_check > std::chrono::milliseconds(2) and _period > 1) {
+        _period /= 2;
+    }
+    _last_check = now;
+    _countdown = _period;
+    _reached = now >= _limit or Parameters::p->time_limit_reached(now);
+    return _reached;
+}
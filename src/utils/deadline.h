@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+
+/**
+ * @brief Time limit of a loop that reads the clock only every few calls
+ *
+ * The number of calls between two reads of the clock adapts to the duration of the
+ * iterations of the loop so the clock is read about once per millisecond. The time
+ * limit (given limit or time limit of the search) is then exceeded by about one
+ * millisecond at most.
+ *
+ */
+class Deadline {
+    /** @brief Time limit of the loop*/
+    std::chrono::high_resolution_clock::time_point _limit;
+    /** @brief Time of the last read of the clock*/
+    std::chrono::high_resolution_clock::time_point _last_check{};
+    /** @brief Number of calls between two reads of the clock*/
+    long _period{1};
+    /** @brief Number of calls before the next read of the clock*/
+    long _countdown{1};
+    /** @brief True once the time limit is reached*/
+    bool _reached{false};
+
+  public:
+    /**
+     * @brief Construct a new deadline
+     *
+     * @param limit time limit of the loop (none by default, only the time limit of the
+     * search)
+     */
+    explicit Deadline(const std::chrono::high_resolution_clock::time_point &limit =
+                          std::chrono::high_resolution_clock::time_point::max());
+
+    /**
+     * @brief Change the time limit, the clock is read at the next call to reached
+     *
+     * @param limit new time limit of the loop
+     */
+    void reset(const std::chrono::high_resolution_clock::time_point &limit);
+
+    /**
+     * @brief Return true if the time limit of the loop or of the search is reached
+     *
+     * @return true the time limit is reached
+     * @return false the loop continues
+     */
+    [[nodiscard]] bool reached();
+};
@@ -0,0 +1,299 @@
+#include "moves_scan.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "../representation/Graph.h"
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+#define MOVES_SCAN_AVX2
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/** @brief Parameters of the scan of the moves to a color*/
+struct ColorScan {
+    const int *colors;
+    const int *conflicts;
+    const int *weights;
+    const int *delta_scores;
+    const int *vertex_conflicts;
+    int nb_vertices;
+    int color;
+    int max_weight;
+    int score_coeff;
+    int conflicts_coeff;
+    int max_delta_score;
+    int max_delta_conflicts;
+};
+
+/**
+ * @brief Return the key of the move of the vertex (max int if the move isn't possible)
+ *
+ * @param scan the scan
+ * @param vertex the vertex
+ * @return int the key
+ */
+int scalar_key(const ColorScan &scan, const int vertex) {
+    const int delta_score{scan.delta_scores[vertex] +
+                          std::max(scan.weights[vertex] - scan.max_weight, 0)};
+    const int delta_conflicts{scan.conflicts[vertex] - scan.vertex_conflicts[vertex]};
+    if (scan.colors[vertex] == scan.color or delta_score >= scan.max_delta_score or
+        delta_conflicts > scan.max_delta_conflicts) {
+        return std::numeric_limits<int>::max();
+    }
+    return scan.score_coeff * delta_score + scan.conflicts_coeff * delta_conflicts;
+}
+
+/**
+ * @brief Return the lowest key of the moves of the vertices from the first vertex
+ *
+ * @param scan the scan
+ * @param first_vertex the first vertex
+ * @return int the lowest key
+ */
+int scalar_lowest_key(const ColorScan &scan, const int first_vertex) {
+    int best_key{std::numeric_limits<int>::max()};
+    for (int vertex{first_vertex}; vertex < scan.nb_vertices; ++vertex) {
+        best_key = std::min(best_key, scalar_key(scan, vertex));
+    }
+    return best_key;
+}
+
+/**
+ * @brief Count the moves with the key of the vertices from the first vertex
+ *
+ * @param scan the scan
+ * @param first_vertex the first vertex
+ * @param best_key the key
+ * @param nb_moves for each vertex, number of moves with the key
+ * @return int number of moves with the key
+ */
+int scalar_count_moves(const ColorScan &scan,
+                       const int first_vertex,
+                       const int best_key,
+                       int *nb_moves) {
+    int count{0};
+    for (int vertex{first_vertex}; vertex < scan.nb_vertices; ++vertex) {
+        if (scalar_key(scan, vertex) == best_key) {
+            ++nb_moves[vertex];
+            ++count;
+        }
+    }
+    return count;
+}
+
+#ifdef MOVES_SCAN_AVX2
+
+/**
+ * @brief Return true if the processor has the AVX2 instructions
+ *
+ * @return true the AVX2 kernels can be used
+ * @return false the scalar kernels must be used
+ */
+bool cpu_has_avx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+}
+
+/** @brief True if the processor has the AVX2 instructions*/
+const bool has_avx2{cpu_has_avx2()};
+
+/**
+ * @brief Load 8 integers
+ *
+ * @param values the integers
+ * @return __m256i the vector
+ */
+__attribute__((target("avx2"))) inline __m256i load(const int *values) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+}
+
+/**
+ * @brief Compute the keys of the moves of 8 vertices (max int if not possible)
+ *
+ * @param scan the scan
+ * @param vertex first of the 8 vertices
+ * @return __m256i the keys
+ */
+__attribute__((target("avx2"))) inline __m256i avx2_keys(const ColorScan &scan,
+                                                          const int vertex) {
+    const __m256i entering_deltas{_mm256_max_epi32(
+        _mm256_sub_epi32(load(scan.weights + vertex), _mm256_set1_epi32(scan.max_weight)),
+        _mm256_setzero_si256())};
+    const __m256i delta_scores{
+        _mm256_add_epi32(load(scan.delta_scores + vertex), entering_deltas)};
+    const __m256i delta_conflicts{_mm256_sub_epi32(
+        load(scan.conflicts + vertex), load(scan.vertex_conflicts + vertex))};
+    const __m256i impossible{_mm256_or_si256(
+        _mm256_cmpeq_epi32(load(scan.colors + vertex), _mm256_set1_epi32(scan.color)),
+        _mm256_or_si256(
+            _mm256_cmpgt_epi32(delta_scores, _mm256_set1_epi32(scan.max_delta_score - 1)),
+            _mm256_cmpgt_epi32(delta_conflicts,
+                               _mm256_set1_epi32(scan.max_delta_conflicts))))};
+    const __m256i keys{_mm256_add_epi32(
+        _mm256_mullo_epi32(delta_scores, _mm256_set1_epi32(scan.score_coeff)),
+        _mm256_mullo_epi32(delta_conflicts, _mm256_set1_epi32(scan.conflicts_coeff)))};
+    return _mm256_blendv_epi8(
+        keys, _mm256_set1_epi32(std::numeric_limits<int>::max()), impossible);
+}
+
+/**
+ * @brief Return the lowest key of the moves of the vertices
+ *
+ * @param scan the scan
+ * @return int the lowest key
+ */
+__attribute__((target("avx2"))) int avx2_lowest_key(const ColorScan &scan) {
+    __m256i best_keys{_mm256_set1_epi32(std::numeric_limits<int>::max())};
+    int vertex{0};
+    for (; vertex + 8 <= scan.nb_vertices; vertex += 8) {
+        best_keys = _mm256_min_epi32(best_keys, avx2_keys(scan, vertex));
+    }
+    alignas(32) int keys[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(keys), best_keys);
+    return std::min(*std::min_element(keys, keys + 8), scalar_lowest_key(scan, vertex));
+}
+
+/**
+ * @brief Count the moves with the key of the vertices
+ *
+ * @param scan the scan
+ * @param best_key the key
+ * @param nb_moves for each vertex, number of moves with the key
+ * @return int number of moves with the key
+ */
+__attribute__((target("avx2"))) int
+avx2_count_moves(const ColorScan &scan, const int best_key, int *nb_moves) {
+    const __m256i best_keys{_mm256_set1_epi32(best_key)};
+    __m256i counts{_mm256_setzero_si256()};
+    int vertex{0};
+    for (; vertex + 8 <= scan.nb_vertices; vertex += 8) {
+        // -1 for the moves with the key
+        const __m256i found{_mm256_cmpeq_epi32(avx2_keys(scan, vertex), best_keys)};
+        counts = _mm256_sub_epi32(counts, found);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(nb_moves + vertex),
+                            _mm256_sub_epi32(load(nb_moves + vertex), found));
+    }
+    alignas(32) int totals[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(totals), counts);
+    int count{0};
+    for (const int total : totals) {
+        count += total;
+    }
+    return count + scalar_count_moves(scan, vertex, best_key, nb_moves);
+}
+
+#endif
+
+} // namespace
+
+MovesScan::MovesScan(const int score_coeff,
+                     const int conflicts_coeff,
+                     const int max_delta_score,
+                     const int max_delta_conflicts)
+    : _score_coeff(score_coeff),
+      _conflicts_coeff(conflicts_coeff),
+      _max_delta_score(max_delta_score),
+      _max_delta_conflicts(max_delta_conflicts),
+      _delta_scores(Graph::g->nb_vertices, 0),
+      _conflicts(Graph::g->nb_vertices, 0),
+      _nb_moves(Graph::g->nb_vertices, 0) {
+}
+
+void MovesScan::set_coefficients(const int score_coeff,
+                                 const int conflicts_coeff,
+                                 const int max_delta_score,
+                                 const int max_delta_conflicts) {
+    _score_coeff = score_coeff;
+    _conflicts_coeff = conflicts_coeff;
+    _max_delta_score = max_delta_score;
+    _max_delta_conflicts = max_delta_conflicts;
+}
+
+void MovesScan::set_vertex(const int vertex, const int delta_score, const int conflicts) {
+    _delta_scores[vertex] = delta_score;
+    _conflicts[vertex] = conflicts;
+}
+
+void MovesScan::exclude_vertex(const int vertex) {
+    // the delta of the vertex entering a color is positive or null
+    _delta_scores[vertex] = _max_delta_score;
+}
+
+[[nodiscard]] bool MovesScan::few_candidates() const {
+    // a vertex evaluated alone costs about as much as 16 vertices scanned with AVX2 or 2
+    // vertices scanned with the scalar loop
+    int ratio{2};
+#ifdef MOVES_SCAN_AVX2
+    if (has_avx2) {
+        ratio = 16;
+    }
+#endif
+    return static_cast<int>(_candidates.size()) * ratio < Graph::g->nb_vertices;
+}
+
+[[nodiscard]] int MovesScan::key(const int vertex,
+                                 const int vertex_color,
+                                 const int color,
+                                 const int conflicts,
+                                 const int max_weight) const {
+    const int delta_score{_delta_scores[vertex] +
+                          std::max(Graph::g->weights[vertex] - max_weight, 0)};
+    const int delta_conflicts{conflicts - _conflicts[vertex]};
+    if (vertex_color == color or delta_score >= _max_delta_score or
+        delta_conflicts > _max_delta_conflicts) {
+        return std::numeric_limits<int>::max();
+    }
+    return _score_coeff * delta_score + _conflicts_coeff * delta_conflicts;
+}
+
+[[nodiscard]] int MovesScan::lowest_key(const std::vector<int> &colors,
+                                        const int *conflicts,
+                                        const int color,
+                                        const int max_weight) const {
+    const ColorScan scan{colors.data(),
+                         conflicts,
+                         Graph::g->weights.data(),
+                         _delta_scores.data(),
+                         _conflicts.data(),
+                         Graph::g->nb_vertices,
+                         color,
+                         max_weight,
+                         _score_coeff,
+                         _conflicts_coeff,
+                         _max_delta_score,
+                         _max_delta_conflicts};
+#ifdef MOVES_SCAN_AVX2
+    if (has_avx2) {
+        return avx2_lowest_key(scan);
+    }
+#endif
+    return scalar_lowest_key(scan, 0);
+}
+
+int MovesScan::count_moves(const std::vector<int> &colors,
+                           const int *conflicts,
+                           const int color,
+                           const int max_weight,
+                           const int best_key) {
+    const ColorScan scan{colors.data(),
+                         conflicts,
+                         Graph::g->weights.data(),
+                         _delta_scores.data(),
+                         _conflicts.data(),
+                         Graph::g->nb_vertices,
+                         color,
+                         max_weight,
+                         _score_coeff,
+                         _conflicts_coeff,
+                         _max_delta_score,
+                         _max_delta_conflicts};
+#ifdef MOVES_SCAN_AVX2
+    if (has_avx2) {
+        return avx2_count_moves(scan, best_key, _nb_moves.data());
+    }
+#endif
+    return scalar_count_moves(scan, 0, best_key, _nb_moves.data());
+}
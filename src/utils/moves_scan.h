@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "../representation/enum_types.h"
+#include "random_generator.h"
+
+/**
+ * @brief Scan of the moves of the vertices to the non empty colors of a solution
+ *
+ * As the delta of a vertex entering a color is positive or null, only the vertices whose
+ * delta leaving their color is lower than max_delta_score can have possible moves. When
+ * these vertices are few, their moves are evaluated one by one. Otherwise the colors are
+ * scanned one by one on all the vertices with AVX2 instructions (8 vertices at once) when
+ * the processor has them, or with a scalar loop.
+ *
+ * The delta on the score of a move is the delta of the vertex leaving its color (given
+ * for each vertex) plus the delta of the vertex entering the color (computed with the
+ * heaviest weight of the color). The delta on the conflicts is the number of conflicts
+ * of the vertex in the color minus in its color (given for each vertex).
+ *
+ * A move is possible if the color isn't the color of the vertex, if its delta on the
+ * score is lower than max_delta_score and if its delta on the conflicts is lower or equal
+ * to max_delta_conflicts. The key of a move is score_coeff * delta score +
+ * conflicts_coeff * delta conflicts, the best moves are the possible moves with the
+ * lowest key.
+ *
+ */
+class MovesScan {
+
+    /** @brief Coefficient of the delta on the score in the key*/
+    int _score_coeff;
+    /** @brief Coefficient of the delta on the conflicts in the key*/
+    int _conflicts_coeff;
+    /** @brief The delta on the score of a possible move is lower*/
+    int _max_delta_score;
+    /** @brief The delta on the conflicts of a possible move is lower or equal*/
+    int _max_delta_conflicts;
+
+    /** @brief For each vertex, delta on the score of the vertex leaving its color*/
+    std::vector<int> _delta_scores;
+    /** @brief For each vertex, number of conflicts of the vertex in its color*/
+    std::vector<int> _conflicts;
+    /** @brief For each vertex, number of best moves of the vertex*/
+    std::vector<int> _nb_moves;
+    /** @brief Vertices that can have possible moves*/
+    std::vector<int> _candidates{};
+    /** @brief Best moves found when the candidates are evaluated one by one*/
+    std::vector<Coloration> _best_moves{};
+
+    /**
+     * @brief Return true if the moves of the candidates should be evaluated one by one
+     * instead of scanning the colors on all the vertices
+     *
+     * @return true the candidates are few
+     * @return false the colors must be scanned
+     */
+    [[nodiscard]] bool few_candidates() const;
+
+    /**
+     * @brief Return the key of the move of the vertex to the color, max int if the move
+     * isn't possible
+     *
+     * @param vertex the vertex
+     * @param vertex_color color of the vertex
+     * @param color the color
+     * @param conflicts number of conflicts of the vertex in the color
+     * @param max_weight heaviest weight of the color
+     * @return int the key of the move
+     */
+    [[nodiscard]] int key(const int vertex,
+                          const int vertex_color,
+                          const int color,
+                          const int conflicts,
+                          const int max_weight) const;
+
+    /**
+     * @brief Return the lowest key of the moves of all the vertices to the color
+     *
+     * @param colors colors of the vertices
+     * @param conflicts for each vertex, number of conflicts in the color
+     * @param color the color
+     * @param max_weight heaviest weight of the color
+     * @return int the lowest key, max int if no move is possible
+     */
+    [[nodiscard]] int lowest_key(const std::vector<int> &colors,
+                                 const int *conflicts,
+                                 const int color,
+                                 const int max_weight) const;
+
+    /**
+     * @brief Count, for each vertex, its moves to the color with the key
+     *
+     * @param colors colors of the vertices
+     * @param conflicts for each vertex, number of conflicts in the color
+     * @param color the color
+     * @param max_weight heaviest weight of the color
+     * @param best_key the key
+     * @return int number of moves with the key
+     */
+    int count_moves(const std::vector<int> &colors,
+                    const int *conflicts,
+                    const int color,
+                    const int max_weight,
+                    const int best_key);
+
+  public:
+    MovesScan() = delete;
+
+    /**
+     * @brief Construct a scan of the moves
+     *
+     * @param score_coeff coefficient of the delta on the score in the key
+     * @param conflicts_coeff coefficient of the delta on the conflicts in the key
+     * @param max_delta_score the delta on the score of a possible move is lower
+     * @param max_delta_conflicts the delta on the conflicts of a possible move is lower
+     * or equal
+     */
+    MovesScan(const int score_coeff,
+              const int conflicts_coeff,
+              const int max_delta_score,
+              const int max_delta_conflicts);
+
+    /**
+     * @brief Change the coefficients and the bounds of the scan to reuse it, all the
+     * vertices must then be set (or excluded) again
+     *
+     * @param score_coeff coefficient of the delta on the score in the key
+     * @param conflicts_coeff coefficient of the delta on the conflicts in the key
+     * @param max_delta_score the delta on the score of a possible move is lower
+     * @param max_delta_conflicts the delta on the conflicts of a possible move is lower
+     * or equal
+     */
+    void set_coefficients(const int score_coeff,
+                          const int conflicts_coeff,
+                          const int max_delta_score,
+                          const int max_delta_conflicts);
+
+    /**
+     * @brief Set the delta on the score of the vertex leaving its color and its number
+     * of conflicts in its color
+     *
+     * @param vertex the vertex
+     * @param delta_score delta on the score of the vertex leaving its color
+     * @param conflicts number of conflicts of the vertex in its color
+     */
+    void set_vertex(const int vertex, const int delta_score, const int conflicts);
+
+    /**
+     * @brief Forbid the moves of the vertex (until the next call to set_vertex)
+     *
+     * @param vertex the vertex
+     */
+    void exclude_vertex(const int vertex);
+
+    /**
+     * @brief Return a random move among the best moves, same draw as rd::choice on the
+     * list of the best moves sorted by vertex then by color in the order of the non empty
+     * colors
+     *
+     * @tparam S type of the solution (Solution or proxi solution)
+     * @param solution the solution
+     * @return Coloration the move, vertex -1 if no move is possible
+     */
+    template <typename S> [[nodiscard]] Coloration random_best_move(const S &solution) {
+        const std::vector<int> &colors{solution.colors()};
+        _candidates.clear();
+        for (int vertex{0}; vertex < static_cast<int>(colors.size()); ++vertex) {
+            if (_delta_scores[vertex] < _max_delta_score) {
+                _candidates.push_back(vertex);
+            }
+        }
+        if (_candidates.empty()) {
+            return Coloration{-1, -1};
+        }
+        int best_key{std::numeric_limits<int>::max()};
+        if (few_candidates()) {
+            _best_moves.clear();
+            for (const int vertex : _candidates) {
+                for (const int color : solution.non_empty_colors()) {
+                    const int move_key{key(vertex,
+                                           colors[vertex],
+                                           color,
+                                           solution.conflicts_colors(color, vertex),
+                                           solution.max_weight(color))};
+                    if (move_key == std::numeric_limits<int>::max() or
+                        move_key > best_key) {
+                        continue;
+                    }
+                    if (move_key < best_key) {
+                        best_key = move_key;
+                        _best_moves.clear();
+                    }
+                    _best_moves.push_back(Coloration{vertex, color});
+                }
+            }
+            if (_best_moves.empty()) {
+                return Coloration{-1, -1};
+            }
+            return rd::choice(_best_moves);
+        }
+        for (const int color : solution.non_empty_colors()) {
+            best_key = std::min(best_key,
+                                lowest_key(colors,
+                                           solution.conflicts_colors(color).begin(),
+                                           color,
+                                           solution.max_weight(color)));
+        }
+        if (best_key == std::numeric_limits<int>::max()) {
+            return Coloration{-1, -1};
+        }
+        std::fill(_nb_moves.begin(), _nb_moves.end(), 0);
+        int nb_moves{0};
+        for (const int color : solution.non_empty_colors()) {
+            nb_moves += count_moves(colors,
+                                    solution.conflicts_colors(color).begin(),
+                                    color,
+                                    solution.max_weight(color),
+                                    best_key);
+        }
+        int index{rd::uniform(0, nb_moves - 1)};
+        int vertex{_candidates.front()};
+        while (index >= _nb_moves[vertex]) {
+            index -= _nb_moves[vertex];
+            ++vertex;
+        }
+        for (const int color : solution.non_empty_colors()) {
+            if (key(vertex,
+                    colors[vertex],
+                    color,
+                    solution.conflicts_colors(color, vertex),
+                    solution.max_weight(color)) != best_key) {
+                continue;
+            }
+            if (index == 0) {
+                return Coloration{vertex, color};
+            }
+            --index;
+        }
+        return Coloration{-1, -1};
+    }
+};
@@ -1,6 +1,49 @@
 #include "random_generator.h"
 
+#include <cstddef>
+
 namespace rd {
 // init generator (set rand seed in src/main.cpp)
-std::mt19937 generator;
+thread_local Xoshiro256 generator;
+
+Xoshiro256::Xoshiro256(const uint64_t seed_) {
+    seed(seed_);
+}
+
+void Xoshiro256::seed(const uint64_t seed_) {
+    // splitmix64 spreads the bits of the seed over the whole state (never all zeros)
+    uint64_t z{seed_};
+    for (auto &state : _state) {
+        z += 0x9e3779b97f4a7c15;
+        uint64_t value{z};
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+        state = value ^ (value >> 31);
+    }
+}
+
+void Xoshiro256::jump() {
+    constexpr std::array<uint64_t, 4> jump_polynomial{
+        0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+    std::array<uint64_t, 4> state{};
+    for (const uint64_t polynomial : jump_polynomial) {
+        for (int bit{0}; bit < 64; ++bit) {
+            if (polynomial & (uint64_t{1} << bit)) {
+                for (size_t i{0}; i < state.size(); ++i) {
+                    state[i] ^= _state[i];
+                }
+            }
+            (*this)();
+        }
+    }
+    _state = state;
+}
+
+void seed(const int rand_seed, const int thread) {
+    generator.seed(static_cast<uint64_t>(static_cast<uint32_t>(rand_seed)));
+    for (int i{0}; i < thread; ++i) {
+        generator.jump();
+    }
+}
+
 } // namespace rd
@@ -1,12 +1,116 @@
 #pragma once
 
-#include <random>
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <set>
 #include <vector>
 
 namespace rd {
-/** @brief random number generator*/
-extern std::mt19937 generator;
+
+/**
+ * @brief xoshiro256** random number generator, faster and smaller than std::mt19937
+ *
+ * It can be used with the distributions and the algorithms of the standard library
+ * (ex : std::shuffle).
+ *
+ */
+class Xoshiro256 {
+    /** @brief State of the generator*/
+    std::array<uint64_t, 4> _state{};
+
+    /**
+     * @brief Rotate the bits of the value to the left
+     *
+     * @param value the value
+     * @param shift number of bits
+     * @return uint64_t rotated value
+     */
+    [[nodiscard]] static constexpr uint64_t rotl(const uint64_t value, const int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+  public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(const uint64_t seed_ = 0);
+
+    /**
+     * @brief Set the state of the generator from the seed (with splitmix64)
+     *
+     * @param seed_ the seed
+     */
+    void seed(const uint64_t seed_);
+
+    /**
+     * @brief Advance the generator of 2^128 numbers, equivalent to 2^128 calls to the
+     * generator, to get a sequence that doesn't overlap the previous one
+     *
+     */
+    void jump();
+
+    [[nodiscard]] static constexpr result_type min() {
+        return 0;
+    }
+
+    [[nodiscard]] static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /**
+     * @brief Return the next random number
+     *
+     * @return result_type the random number
+     */
+    result_type operator()() {
+        const uint64_t result{rotl(_state[1] * 5, 7) * 9};
+        const uint64_t t{_state[1] << 17};
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = rotl(_state[3], 45);
+        return result;
+    }
+};
+
+/** @brief random number generator, one per thread (seeded with rd::seed in src/main.cpp
+ * and by each thread of the search)*/
+extern thread_local Xoshiro256 generator;
+
+/**
+ * @brief Seed the generator of the calling thread, each thread gets a part of the
+ * sequence of the random seed that doesn't overlap the parts of the other threads, so
+ * the parallel searches are reproducible
+ *
+ * @param rand_seed random seed of the search
+ * @param thread number of the thread (0 for the main thread)
+ */
+void seed(const int rand_seed, const int thread);
+
+/**
+ * @brief Return a random integer in [lower, upper] (Lemire's multiply and shift
+ * method, without division in most of the draws)
+ *
+ * @param lower lowest value
+ * @param upper highest value (greater or equal to lower)
+ * @return int the random integer
+ */
+inline int uniform(const int lower, const int upper) {
+    const auto range{static_cast<uint64_t>(static_cast<uint32_t>(upper - lower)) + 1};
+    uint64_t product{(generator() >> 32) * range};
+    auto low{static_cast<uint32_t>(product)};
+    if (low < range) {
+        // reject the draws that would make the lowest values more likely
+        const auto threshold{static_cast<uint32_t>((uint64_t{1} << 32) % range)};
+        while (low < threshold) {
+            product = (generator() >> 32) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return lower + static_cast<int>(product >> 32);
+}
 
 /**
  * @brief Get the random value from a non empty container
@@ -16,17 +120,11 @@ extern std::mt19937 generator;
  * @return T random element from the vector
  */
 template <typename T> T choice(const std::vector<T> &vector) {
-    auto begin{vector.begin()};
-    std::uniform_int_distribution<> dis(
-        0, static_cast<int>(std::distance(begin, vector.end())) - 1);
-    std::advance(begin, dis(generator));
-    return *begin;
+    return vector[uniform(0, static_cast<int>(vector.size()) - 1)];
 }
 template <typename T> T choice(const std::set<T> &set) {
     auto begin{set.begin()};
-    std::uniform_int_distribution<> dis(
-        0, static_cast<int>(std::distance(begin, set.end())) - 1);
-    std::advance(begin, dis(generator));
+    std::advance(begin, uniform(0, static_cast<int>(set.size()) - 1));
     return *begin;
 }
 
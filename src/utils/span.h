@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Non owning view on a contiguous sequence of values (like std::span in C++20)
+ *
+ * @tparam T value type
+ */
+template <typename T> class Span {
+    /** @brief First element of the sequence*/
+    T *_first;
+    /** @brief Past the last element of the sequence*/
+    T *_last;
+
+  public:
+    /**
+     * @brief Construct a new Span on [first, last)
+     *
+     * @param first first element
+     * @param last past the last element
+     */
+    Span(T *first, T *last) : _first(first), _last(last) {
+    }
+
+    [[nodiscard]] T *begin() const {
+        return _first;
+    }
+
+    [[nodiscard]] T *end() const {
+        return _last;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return static_cast<std::size_t>(_last - _first);
+    }
+
+    [[nodiscard]] bool empty() const {
+        return _first == _last;
+    }
+
+    [[nodiscard]] T &operator[](const std::size_t index) const {
+        return _first[index];
+    }
+};
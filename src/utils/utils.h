@@ -1,5 +1,6 @@
 #pragma once
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -51,6 +52,34 @@ int get_index_max_element(std::vector<std::vector<T>> &vector, Compare comp) {
         vector.begin(), std::max_element(vector.begin(), vector.end(), comp)));
 }
 
+/**
+ * @brief Set the atomic value to the given value if it is lower (shared minimum between
+ * threads)
+ *
+ * @tparam T value type
+ * @param atomic_value value to update
+ * @param value new value
+ */
+template <typename T> void atomic_min(std::atomic<T> &atomic_value, const T value) {
+    T current{atomic_value.load()};
+    while (value < current and not atomic_value.compare_exchange_weak(current, value)) {
+    }
+}
+
+/**
+ * @brief Set the atomic value to the given value if it is higher (shared maximum between
+ * threads)
+ *
+ * @tparam T value type
+ * @param atomic_value value to update
+ * @param value new value
+ */
+template <typename T> void atomic_max(std::atomic<T> &atomic_value, const T value) {
+    T current{atomic_value.load()};
+    while (value > current and not atomic_value.compare_exchange_weak(current, value)) {
+    }
+}
+
 /**
  * @brief Return the sum of a vector
  *